@@ -1,26 +1,66 @@
 #include "algorithm.h"
+#include "frontier.h"
+#include "nodepool.h"
+#include "permutation.h"
+#include "oracle.h"
+#include "mailbox.h"
+#include "patterndb.h"
+#include "phaseprofile.h"
+#include "stopwatch.h"
 #include <vector>
-#include <unordered_set>
+#include <deque>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
 #include <omp.h>
 
 using namespace std;
 
+SearchOptions g_searchOptions;
+
+//looks up the goal's tables and, if asked for, the pattern database, building them on first use,
+//so that building them is reported as setup time and not as search time (added to what is there)
+template<class Puzzle>
+static void prepareTables(string const goalState, bool withPatternDatabase, SearchResult &result) {
+   Stopwatch setup;
+   Puzzle goal(goalState, goalState);
+   if (withPatternDatabase) {
+      PatternDatabase::instance();
+   }
+   result.setupWallTimeNs += setup.wallNanoseconds();
+   result.setupCpuTimeNs += setup.cpuNanoseconds();
+}
+
+static void recordSearchTime(const Stopwatch &search, SearchResult &result) {
+   result.searchWallTimeNs = search.wallNanoseconds();
+   result.searchCpuTimeNs = search.cpuNanoseconds();
+   result.actualRunningTime = (float)(result.searchWallTimeNs * 1e-9);
+}
+
 enum class CompareType {
     PATH_LENGTH,
     F_COST
 };
 
+template<class Puzzle>
 struct DuplicateResult {
     bool found;
-    int index;
+    Puzzle *queued; //the node already waiting in the queue for the same state
     bool newIsBetter;
     
-    DuplicateResult() : found(false), index(-1), newIsBetter(false) {}
+    DuplicateResult() : found(false), queued(NULL), newIsBetter(false) {}
 };
 
-DuplicateResult checkQueueForDuplicateParallel(vector<Puzzle*>& puzzleQueue, Puzzle*& newPuzzle, CompareType compareType) {
-    DuplicateResult result;
-    const string& newState = newPuzzle->toString();
+//maps every state currently waiting in the queue to its node, so duplicates are found without scanning
+template<class Puzzle>
+using QueueIndex = unordered_map<typename Puzzle::State, Puzzle*, PuzzleStateHash>;
+
+template<class Puzzle>
+DuplicateResult<Puzzle> checkQueueForDuplicateParallel(vector<Puzzle*>& puzzleQueue, Puzzle*& newPuzzle, CompareType compareType) {
+    DuplicateResult<Puzzle> result;
+    const typename Puzzle::State newState = newPuzzle->getState();
     const int queueSize = static_cast<int>(puzzleQueue.size());
     
     int foundIndex = -1;
@@ -35,7 +75,7 @@ DuplicateResult checkQueueForDuplicateParallel(vector<Puzzle*>& puzzleQueue, Puz
         for (int i = 0; i < queueSize; i++) {
             if (foundIndex != -1) continue;
             
-            if (puzzleQueue[i]->toString() == newState) {
+            if (puzzleQueue[i]->getState() == newState) {
                 localFoundIndex = i;
                 
                 if (compareType == CompareType::PATH_LENGTH) {
@@ -56,362 +96,1023 @@ DuplicateResult checkQueueForDuplicateParallel(vector<Puzzle*>& puzzleQueue, Puz
     }
     
     result.found = (foundIndex != -1);
-    result.index = foundIndex;
+    result.queued = result.found ? puzzleQueue[foundIndex] : NULL;
     result.newIsBetter = newIsBetter;
     return result;
 }
 
+template<class Puzzle>
+DuplicateResult<Puzzle> checkQueueForDuplicateIndexed(QueueIndex<Puzzle>& queueIndex, Puzzle*& newPuzzle, CompareType compareType) {
+    DuplicateResult<Puzzle> result;
+    
+    typename QueueIndex<Puzzle>::iterator it = queueIndex.find(newPuzzle->getState());
+    if (it == queueIndex.end()) {
+        return result;
+    }
+    
+    Puzzle* queued = it->second;
+    result.found = true;
+    if (compareType == CompareType::PATH_LENGTH) {
+        result.newIsBetter = (newPuzzle->getPathLength() < queued->getPathLength());
+    } else {
+        result.newIsBetter = (newPuzzle->getFCost() < queued->getFCost());
+    }
+    result.queued = queued;
+    return result;
+}
+
+//the queue's nodes are only listed for the linear scan; a bucket queue has to copy them out for it
+template<class Puzzle, class Queue>
+DuplicateResult<Puzzle> checkQueueForDuplicate(QueueIndex<Puzzle>& queueIndex, Queue& puzzleQueue, Puzzle*& newPuzzle, CompareType compareType) {
+    if (g_searchOptions.duplicateCheck == parallelLinearScan) {
+        return checkQueueForDuplicateParallel(puzzleQueue.items(), newPuzzle, compareType);
+    }
+    return checkQueueForDuplicateIndexed(queueIndex, newPuzzle, compareType);
+}
+
+//keeps the queue index in step with the heap; skipped entirely when the linear scan is selected
+template<class Puzzle>
+void indexQueuedState(QueueIndex<Puzzle>& queueIndex, Puzzle* p) {
+    if (g_searchOptions.duplicateCheck == hashIndexLookup) {
+        queueIndex[p->getState()] = p;
+    }
+}
+
+template<class Puzzle>
+void unindexQueuedState(QueueIndex<Puzzle>& queueIndex, typename Puzzle::State state) {
+    if (g_searchOptions.duplicateCheck == hashIndexLookup) {
+        queueIndex.erase(state);
+    }
+}
+
+//false when 'move' would only undo the move that produced p; such a successor is its own
+//grandparent, so it is skipped before it costs an expanded-list or queue lookup
+template<class Puzzle>
+bool allowMove(Puzzle* p, char move, int &numOfLocalLoopsAvoided) {
+    if (g_searchOptions.pruneParentMove && p->getLastMove() == inverseMove(move)) {
+        numOfLocalLoopsAvoided++;
+        return false;
+    }
+    return true;
+}
+
+//the node one legal move away from p, allocated from pool
+template<class Puzzle>
+Puzzle *successorOf(Puzzle *p, char move, NodePool<Puzzle> &pool) {
+    switch (move) {
+        case 'U': return p->moveUp(&pool);
+        case 'R': return p->moveRight(&pool);
+        case 'D': return p->moveDown(&pool);
+        default:  return p->moveLeft(&pool);
+    }
+}
+
+//the board sizes every search is compiled for, see the instantiations at the end of puzzle.cpp
+enum boardSize{board3x3, board3x4, board4x4, board5x5};
+
+//the size both states are written for; throws invalid_argument when they differ or the size is not compiled in
+static boardSize boardSizeOf(string const initialState, string const goalState) {
+   vector<int> tiles;
+   BoardShape initial = parseBoard(initialState, tiles);
+   BoardShape goal = parseBoard(goalState, tiles);
+   
+   if (initial.rows != goal.rows || initial.cols != goal.cols) {
+      throw invalid_argument("the initial and goal states are for boards of different sizes");
+   }
+   if (initial.rows == 3 && initial.cols == 3) return board3x3;
+   if (initial.rows == 3 && initial.cols == 4) return board3x4;
+   if (initial.rows == 4 && initial.cols == 4) return board4x4;
+   if (initial.rows == 5 && initial.cols == 5) return board5x5;
+   throw invalid_argument("no search is compiled for " + to_string(initial.rows) + "x" + to_string(initial.cols) + " boards (3x3, 3x4, 4x4 and 5x5 are)");
+}
+
+template<int ROWS, int COLS>
+static bool sameParityClass(string const initialState, string const goalState) {
+   typedef BoardLayout<ROWS, COLS> Layout;
+   return Layout::parityClass(Layout::fromString(initialState)) == Layout::parityClass(Layout::fromString(goalState));
+}
+
+//whether the goal can be reached at all; checked before every search, since on the larger boards an unsolvable
+//pair would otherwise have the searches fill memory with half the state space (and IDA* never stop)
+static bool solvablePair(boardSize size, string const initialState, string const goalState) {
+   switch (size) {
+      case board3x4: return sameParityClass<3, 4>(initialState, goalState);
+      case board4x4: return sameParityClass<4, 4>(initialState, goalState);
+      case board5x5: return sameParityClass<5, 5>(initialState, goalState);
+      default:       return sameParityClass<3, 3>(initialState, goalState);
+   }
+}
+
+//the rank bitset, the distance oracle and the pattern database are tables over the 3x3 board only
+static void requireClassicBoard(boardSize size, bool needed, string const feature) {
+   if (needed && size != board3x3) {
+      throw invalid_argument(feature + " is only available for 3x3 boards");
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// Search Algorithm:  UC with Strict Expanded List
+// Search engine:  best-first search with the Strict Expanded List (UC and A*)
 //
-// Move Generator:  
+// One loop for both searches, put together from compile-time policies:
+//    Cost   - how nodes are evaluated and ordered: UniformCost or AStarCost<heuristic>
+//    Queue  - the open list: IndexedHeap or BucketQueue
+//    Closed - the strict expanded list: HashClosedList or RankBitsetClosedList
+// Each combination is a separate instantiation, so the heuristic update and the data
+// structures are inlined into the loop rather than dispatched on every successor.
 //
 ////////////////////////////////////////////////////////////////////////////////////////////
-string uc_explist(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
-                               float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions){
-                                 
-   string path;
-   clock_t startTime;
-   
-   numOfDeletionsFromMiddleOfHeap=0;
-   numOfLocalLoopsAvoided=0;
-   numOfAttemptedNodeReExpansions=0;
-   maxQLength=0;
-   numOfStateExpansions =0;
-   actualRunningTime=0.0;  
-   startTime = clock();
+
+//UC: nodes are ordered by path cost alone
+struct UniformCost {
+   static const CompareType compareType = CompareType::PATH_LENGTH;
+   static const bool PATTERN_DATABASE = false;
    
-   struct UCComparator {
+   template<class Puzzle> static void evaluate(Puzzle *) {}
+   template<class Puzzle> static void evaluate(Puzzle *, const Puzzle &) {}
+   
+   template<class Puzzle>
+   struct Order {
       bool operator()(Puzzle *p1, Puzzle *p2) {
          return p1->getPathLength() > p2->getPathLength();
       }
+      // bucket queue keys: by path cost alone
+      static int key(Puzzle *p) { return p->getPathLength(); }
+      static int tieKey(Puzzle *) { return 0; }
    };
+};
+
+//A*: f = g + h, with h updated incrementally from the parent
+template<heuristicFunction H>
+struct AStarCost {
+   static const CompareType compareType = CompareType::F_COST;
+   static const bool PATTERN_DATABASE = (H == patternDatabase);
    
+   template<class Puzzle> static void evaluate(Puzzle *p) {
+      p->updateHCost(H);
+      p->updateFCost();
+   }
+   template<class Puzzle> static void evaluate(Puzzle *p, const Puzzle &parent) {
+      p->template updateHCost<H>(parent);
+      p->updateFCost();
+   }
    
-   unordered_set<string> expandedList; // unordered set to use hashing
-   vector<Puzzle*> puzzleQueue; //use pointers to save space
+   // lower f-cost first with tie breaking criteria that priositises larger g-cost
+   template<class Puzzle>
+   struct Order {
+      bool operator()(Puzzle *p1, Puzzle *p2) {
+         int f1 = p1->getFCost();
+         int f2 = p2->getFCost();
+         
+         if (f1 != f2) {
+            return f1 > f2;
+         }
+         return p1->getGCost() < p2->getGCost();
+      }
+      // the same order for the bucket queue: lowest f first, then largest g
+      static int key(Puzzle *p) { return p->getFCost(); }
+      static int tieKey(Puzzle *p) { return p->getGCost(); }
+   };
+};
+
+template<class Puzzle, class Cost, template<class, class> class Queue, class Closed>
+struct BestFirstSearch {
    
-   Puzzle *startPuzzle = new Puzzle(initialState, goalState); //create start puzzle
-   puzzleQueue.push_back(startPuzzle); //push it to vector (which will be used as min heap)
+   typedef typename Puzzle::State State;
+   typedef typename Cost::template Order<Puzzle> Order;
    
-   while (!puzzleQueue.empty()) {
-
-      // Track maximum queue length
-      if ((int)puzzleQueue.size() > maxQLength) {
-         maxQLength = (int)puzzleQueue.size();
+   Closed expandedList;
+   Queue<Puzzle, Order> puzzleQueue; //use pointers to save space, each node knows its own queue slot
+   QueueIndex<Puzzle> queueIndex;    //state -> queued node, for O(1) duplicate checks
+   NodePool<Puzzle> pool;            //every node of this search, released in one go when the search returns
+   SearchResult result;
+   
+   //hot-path steps, each charged to its phase in result.phases when built with PROFILE_PHASES
+   bool isExpanded(State state) {
+      PROFILE_PHASE(result.phases, closedListLookup);
+      return expandedList.contains(state);
+   }
+   
+   void enqueue(Puzzle *p) {
+      {
+         PROFILE_PHASE(result.phases, queuePush);
+         puzzleQueue.push(p);
+      }
+      result.numOfQueuePushes++;
+      PROFILE_PHASE(result.phases, duplicateCheck);
+      indexQueuedState(queueIndex, p);
+   }
+   
+   Puzzle *generateSuccessor(Puzzle *current, char move) {
+      PROFILE_PHASE(result.phases, successorGeneration);
+      return successorOf(current, move, pool);
+   }
+   
+   //queues a successor unless its state is expanded already or queued at least as cheaply
+   void generate(Puzzle *current, Puzzle *successor) {
+      result.numOfNodesGenerated++;
+      
+      if (isExpanded(successor->getState())) {
+         result.numOfAttemptedNodeReExpansions++;
+         pool.release(successor);
+         return;
+      }
+      
+      {
+         PROFILE_PHASE(result.phases, heuristicEvaluation);
+         Cost::evaluate(successor, *current);
       }
       
-      // Get node with lowest path cost
-      pop_heap(puzzleQueue.begin(), puzzleQueue.end(), UCComparator()); // moves front to back and keeps heap structure
-      Puzzle* current = puzzleQueue.back();
-      puzzleQueue.pop_back();
+      DuplicateResult<Puzzle> dupResult;
+      {
+         PROFILE_PHASE(result.phases, duplicateCheck);
+         dupResult = checkQueueForDuplicate(queueIndex, puzzleQueue, successor, Cost::compareType);
+      }
+      if (dupResult.found) {
+         if (dupResult.newIsBetter) {
+            // New path is better: decrease-key, the successor takes over the old entry's queue slot
+            {
+               PROFILE_PHASE(result.phases, queueReplace);
+               pool.release(puzzleQueue.replace(dupResult.queued, successor));
+            }
+            result.numOfDeletionsFromMiddleOfHeap++;
+            PROFILE_PHASE(result.phases, duplicateCheck);
+            indexQueuedState(queueIndex, successor);
+         } else {
+            // Old path is better or equal, discard new successor
+            pool.release(successor);
+         }
+      } else {
+         // State not in queue or expanded, add it
+         enqueue(successor);
+      }
+   }
+   
+   SearchResult run(string const initialState, string const goalState) {
+      prepareTables<Puzzle>(goalState, Cost::PATTERN_DATABASE, result);
+      Stopwatch search;
       
-      string currentState = current->toString();
+      Puzzle *startPuzzle = pool.create(Puzzle(initialState, goalState));
+      Cost::evaluate(startPuzzle);
+      enqueue(startPuzzle);
       
-      // Check if we have reached the goal
-      if (current->goalMatch()) {
-         path = current->getPath();
-         pathLength = current->getPathLength();
+      while (!puzzleQueue.empty()) {
+         
+         // Track maximum queue length
+         if (puzzleQueue.size() > result.maxQLength) {
+            result.maxQLength = puzzleQueue.size();
+         }
          
-         // Clean memory
-         delete current;
-         for (Puzzle* p : puzzleQueue) {
-            delete p;
+         // Get the node that comes first in Cost's order
+         Puzzle *current;
+         {
+            PROFILE_PHASE(result.phases, queuePop);
+            current = puzzleQueue.pop();
          }
+         result.numOfQueuePops++;
          
-         actualRunningTime = ((float)(clock() - startTime)/CLOCKS_PER_SEC);
-         return path;
+         State currentState = current->getState();
+         {
+            PROFILE_PHASE(result.phases, duplicateCheck);
+            unindexQueuedState(queueIndex, currentState);
+         }
+         
+         // Strict expanded list check
+         if (isExpanded(currentState)) {
+            result.numOfAttemptedNodeReExpansions++;
+            pool.release(current);
+            continue;
+         }
+         
+         // Goal test
+         if (current->goalMatch()) {
+            result.path = current->getPath();
+            result.pathLength = current->getPathLength();
+            break;
+         }
+         
+         // Add to expanded list
+         {
+            PROFILE_PHASE(result.phases, closedListLookup);
+            expandedList.insert(currentState);
+         }
+         result.numOfStateExpansions++;
+         
+         // Generate successors in the order of up, right, down, left
+         if (current->canMoveUp() && allowMove(current, 'U', result.numOfLocalLoopsAvoided)) {
+            generate(current, generateSuccessor(current, 'U'));
+         }
+         if (current->canMoveRight() && allowMove(current, 'R', result.numOfLocalLoopsAvoided)) {
+            generate(current, generateSuccessor(current, 'R'));
+         }
+         if (current->canMoveDown() && allowMove(current, 'D', result.numOfLocalLoopsAvoided)) {
+            generate(current, generateSuccessor(current, 'D'));
+         }
+         if (current->canMoveLeft() && allowMove(current, 'L', result.numOfLocalLoopsAvoided)) {
+            generate(current, generateSuccessor(current, 'L'));
+         }
+         
+         // current stays in the pool: its successors refer to it as their parent
       }
       
-      // Check if already expanded
-      if (expandedList.find(currentState) != expandedList.end()) { 
-         numOfAttemptedNodeReExpansions++;
-         delete current;
-         continue;
+      // no path found leaves path empty and pathLength 0; memory is released with the pool
+      result.numOfNodeAllocations = (int)pool.getNumOfAllocations();
+      result.peakNodeMemory = pool.getNumOfBytes();
+      recordSearchTime(search, result);
+      return result;
+   }
+};
+
+//picks the engine instantiation for the closed list and frontier selected in g_searchOptions
+template<class Puzzle, class Cost, template<class, class> class Queue>
+static SearchResult bestFirstSearchWith(string const initialState, string const goalState) {
+   if (g_searchOptions.closedList == rankBitsetClosedList) {
+      return BestFirstSearch<Puzzle, Cost, Queue, RankBitsetClosedList<typename Puzzle::State> >().run(initialState, goalState);
+   }
+   return BestFirstSearch<Puzzle, Cost, Queue, HashClosedList<typename Puzzle::State> >().run(initialState, goalState);
+}
+
+template<class Puzzle, class Cost>
+static SearchResult bestFirstSearch(string const initialState, string const goalState) {
+   if (g_searchOptions.frontier == bucketQueueFrontier) {
+      return bestFirstSearchWith<Puzzle, Cost, BucketQueue>(initialState, goalState);
+   }
+   return bestFirstSearchWith<Puzzle, Cost, IndexedHeap>(initialState, goalState);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  UC with Strict Expanded List
+//
+// Move Generator:  BestFirstSearch with UniformCost
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+SearchResult uc_explist(string const initialState, string const goalState){
+   boardSize size = boardSizeOf(initialState, goalState);
+   requireClassicBoard(size, g_searchOptions.closedList == rankBitsetClosedList, "--closed-list=bitset");
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   
+   switch (size) {
+      case board3x4: return bestFirstSearch<BasicPuzzle<3, 4>, UniformCost>(initialState, goalState);
+      case board4x4: return bestFirstSearch<BasicPuzzle<4, 4>, UniformCost>(initialState, goalState);
+      case board5x5: return bestFirstSearch<BasicPuzzle<5, 5>, UniformCost>(initialState, goalState);
+      default:       return bestFirstSearch<Puzzle, UniformCost>(initialState, goalState);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  Bidirectional UC
+//
+// Move Generator:  forwards from the initial state and backwards from the goal state
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+//one direction of the bidirectional search
+template<class Puzzle>
+struct UCDirection {
+   
+   typedef typename Puzzle::State State;
+   
+   struct UCComparator {
+      bool operator()(Puzzle *p1, Puzzle *p2) {
+         return p1->getPathLength() > p2->getPathLength();
       }
+   };
+   
+   IndexedHeap<Puzzle, UCComparator> puzzleQueue;
+   unordered_map<State, Puzzle*, PuzzleStateHash> reached; //best node per state, queued (heapIndex >= 0) or expanded
+   
+   int topPathLength() {
+      return puzzleQueue.at(0)->getPathLength();
+   }
+};
+
+template<class Puzzle>
+static SearchResult ucBidirectionalSearch(string const initialState, string const goalState){
+   
+   typedef typename Puzzle::State State;
+   SearchResult result;
+   prepareTables<Puzzle>(goalState, false, result);
+   prepareTables<Puzzle>(initialState, false, result); //the backward half's goal
+   Stopwatch search;
+   
+   NodePool<Puzzle> pool;
+   UCDirection<Puzzle> forward, backward;
+   
+   // the backward search treats the initial state as its goal
+   Puzzle *startPuzzle = pool.create(Puzzle(initialState, goalState));
+   Puzzle *goalPuzzle = pool.create(Puzzle(goalState, initialState));
+   forward.puzzleQueue.push(startPuzzle);
+   forward.reached[startPuzzle->getState()] = startPuzzle;
+   backward.puzzleQueue.push(goalPuzzle);
+   backward.reached[goalPuzzle->getState()] = goalPuzzle;
+   result.numOfQueuePushes = 2;
+   
+   // cheapest known start -> meetingState -> goal cost; both sides' best nodes for that
+   // state are looked up again at the end, as the nodes seen at meeting time may be replaced
+   int bestCost = (startPuzzle->getState() == goalPuzzle->getState()) ? 0 : -1;
+   State meetingState = startPuzzle->getState();
+   
+   while (!forward.puzzleQueue.empty() && !backward.puzzleQueue.empty()) {
       
-      // Add to expanded list and increment counter
-      expandedList.insert(currentState);
-      numOfStateExpansions++;
-      
-      // Generate successors in the order of up, right, down, left
-      vector<Puzzle*> successors;
-      
-      if (current->canMoveUp()) {
-         successors.push_back(current->moveUp());
+      int queued = forward.puzzleQueue.size() + backward.puzzleQueue.size();
+      if (queued > result.maxQLength) {
+         result.maxQLength = queued;
       }
-      if (current->canMoveRight()) {
-         successors.push_back(current->moveRight());
-      }
-      if (current->canMoveDown()) {
-         successors.push_back(current->moveDown());
+      
+      // no path through an unexpanded node can be shorter than the cheapest one found so far
+      if (bestCost >= 0 && forward.topPathLength() + backward.topPathLength() >= bestCost) {
+         break;
       }
-      if (current->canMoveLeft()) {
-         successors.push_back(current->moveLeft());
+      
+      // expand on the side with the smaller queue
+      bool forwardTurn = forward.puzzleQueue.size() <= backward.puzzleQueue.size();
+      UCDirection<Puzzle> &side = forwardTurn ? forward : backward;
+      UCDirection<Puzzle> &other = forwardTurn ? backward : forward;
+      
+      Puzzle *current;
+      {
+         PROFILE_PHASE(result.phases, queuePop);
+         current = side.puzzleQueue.pop();
       }
+      result.numOfQueuePops++;
+      result.numOfStateExpansions++;
       
-      // Add the valid successors to queue
-      for (Puzzle* successor : successors) {
-         string successorState = successor->toString();
-   
-         // Check if successor is already expanded 
-         if (expandedList.find(successorState) != expandedList.end()) {
-            numOfAttemptedNodeReExpansions++;
-            delete successor;
+      const char moves[4] = {'U', 'R', 'D', 'L'};
+      for (int i = 0; i < 4; i++) {
+         char move = moves[i];
+         bool legal = false;
+         
+         switch (move) {
+            case 'U': legal = current->canMoveUp(); break;
+            case 'R': legal = current->canMoveRight(); break;
+            case 'D': legal = current->canMoveDown(); break;
+            case 'L': legal = current->canMoveLeft(); break;
+         }
+         if (!legal || !allowMove(current, move, result.numOfLocalLoopsAvoided)) continue;
+         
+         Puzzle *successor;
+         {
+            PROFILE_PHASE(result.phases, successorGeneration);
+            successor = successorOf(current, move, pool);
+         }
+         result.numOfNodesGenerated++;
+         
+         State successorState = successor->getState();
+         typename unordered_map<State, Puzzle*, PuzzleStateHash>::iterator it;
+         {
+            PROFILE_PHASE(result.phases, duplicateCheck);
+            it = side.reached.find(successorState);
+         }
+         
+         if (it != side.reached.end()) {
+            Puzzle *old = it->second;
+            if (old->getHeapIndex() < 0) {
+               // already expanded on this side, with uniform costs it cannot be improved
+               result.numOfAttemptedNodeReExpansions++;
+               pool.release(successor);
+               continue;
+            }
+            if (successor->getPathLength() >= old->getPathLength()) {
+               pool.release(successor);
+               continue;
+            }
+            {
+               PROFILE_PHASE(result.phases, queueReplace);
+               pool.release(side.puzzleQueue.replace(old->getHeapIndex(), successor));
+            }
+            result.numOfDeletionsFromMiddleOfHeap++;
+            it->second = successor;
          } else {
-            DuplicateResult dupResult = checkQueueForDuplicateParallel(puzzleQueue, successor, CompareType::PATH_LENGTH);
-            
-            if (dupResult.found) {
-               if (dupResult.newIsBetter) {
-                  // New path is better, remove old one from middle of heap
-                  delete puzzleQueue[dupResult.index];
-                  puzzleQueue.erase(puzzleQueue.begin() + dupResult.index);
-                  numOfDeletionsFromMiddleOfHeap++;
-                  make_heap(puzzleQueue.begin(), puzzleQueue.end(), UCComparator());
-                  // Add the better successor
-                  puzzleQueue.push_back(successor);
-                  push_heap(puzzleQueue.begin(), puzzleQueue.end(), UCComparator());
-               } else {
-                  // Old path is better or equal, discard new successor
-                  delete successor;
-               }
-            } else {
-               // State not in queue, add it
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), UCComparator());
+            {
+               PROFILE_PHASE(result.phases, queuePush);
+               side.puzzleQueue.push(successor);
+            }
+            result.numOfQueuePushes++;
+            PROFILE_PHASE(result.phases, duplicateCheck);
+            side.reached[successorState] = successor;
+         }
+         
+         // meeting test against everything the other side has reached
+         typename unordered_map<State, Puzzle*, PuzzleStateHash>::iterator match = other.reached.find(successorState);
+         if (match != other.reached.end()) {
+            int cost = successor->getPathLength() + match->second->getPathLength();
+            if (bestCost < 0 || cost < bestCost) {
+               bestCost = cost;
+               meetingState = successorState;
             }
          }
       }
       
-      delete current;
+      // current stays in the pool: its successors refer to it as their parent
    }
    
-   // clean up memory
-   actualRunningTime = ((float)(clock() - startTime)/CLOCKS_PER_SEC);
-   pathLength = 0;
-   return ""; // we return empty string if no solution
+   if (bestCost >= 0) {
+      Puzzle *forwardHalf = forward.reached[meetingState];
+      const Puzzle *backwardHalf = backward.reached[meetingState];
+      
+      // forward half as recorded; backward half walked from the meeting state to the goal,
+      // undoing each backward move
+      result.path = forwardHalf->getPath();
+      for (const Puzzle *node = backwardHalf; node->getParent() != NULL; node = node->getParent()) {
+         result.path.push_back(inverseMove(node->getLastMove()));
+      }
+      result.pathLength = (int)result.path.size();
+   }
+   
+   result.numOfNodeAllocations = (int)pool.getNumOfAllocations();
+   result.peakNodeMemory = pool.getNumOfBytes();
+   recordSearchTime(search, result);
+   return result;
+}
+
+SearchResult uc_bidirectional(string const initialState, string const goalState){
+   boardSize size = boardSizeOf(initialState, goalState);
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   switch (size) {
+      case board3x4: return ucBidirectionalSearch<BasicPuzzle<3, 4> >(initialState, goalState);
+      case board4x4: return ucBidirectionalSearch<BasicPuzzle<4, 4> >(initialState, goalState);
+      case board5x5: return ucBidirectionalSearch<BasicPuzzle<5, 5> >(initialState, goalState);
+      default:       return ucBidirectionalSearch<Puzzle>(initialState, goalState);
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
 // Search Algorithm:  A* with the Strict Expanded List
 //
+// Move Generator:  BestFirstSearch with AStarCost, one instantiation per heuristic
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+template<class Puzzle>
+static SearchResult aStarSearch(string const initialState, string const goalState, heuristicFunction heuristic) {
+   switch (heuristic) {
+      case misplacedTiles:    return bestFirstSearch<Puzzle, AStarCost<misplacedTiles> >(initialState, goalState);
+      case manhattanDistance: return bestFirstSearch<Puzzle, AStarCost<manhattanDistance> >(initialState, goalState);
+      case patternDatabase:   return bestFirstSearch<Puzzle, AStarCost<patternDatabase> >(initialState, goalState);
+      case linearConflict:    return bestFirstSearch<Puzzle, AStarCost<linearConflict> >(initialState, goalState);
+   }
+   return SearchResult();
+}
+
+SearchResult aStar_ExpandedList(string const initialState, string const goalState, heuristicFunction heuristic){
+   boardSize size = boardSizeOf(initialState, goalState);
+   requireClassicBoard(size, g_searchOptions.closedList == rankBitsetClosedList, "--closed-list=bitset");
+   requireClassicBoard(size, heuristic == patternDatabase, "the pattern database heuristic");
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   
+   switch (size) {
+      case board3x4: return aStarSearch<BasicPuzzle<3, 4> >(initialState, goalState, heuristic);
+      case board4x4: return aStarSearch<BasicPuzzle<4, 4> >(initialState, goalState, heuristic);
+      case board5x5: return aStarSearch<BasicPuzzle<5, 5> >(initialState, goalState, heuristic);
+      default:       return aStarSearch<Puzzle>(initialState, goalState, heuristic);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  IDA* (iterative deepening A*)
+//
+// Move Generator:  in-place applyMove/undoMove on a single node
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+//state shared by every level of one depth-first iteration
+template<class Puzzle>
+struct IDAStarSearch {
+   Puzzle *node;                   //the only node, moved forwards and back in place
+   heuristicFunction heuristic;
+   int bound;                      //f limit of this iteration
+   int previousBound;              //f limit of the previous iteration, -1 in the first one
+   int nextBound;                  //smallest f seen above the limit
+   string path;                    //moves from the start to node, used as a stack
+   
+   SearchResult result;            //counters; maxQLength is the deepest recursion
+};
+
+static const int NO_BOUND = 1 << 30;
+
+//depth-first search below search.node within search.bound; true once the goal is on the path
+template<class Puzzle>
+static bool idaStarDepthFirst(IDAStarSearch<Puzzle> &search, char lastMove) {
+   
+   Puzzle *node = search.node;
+   int f = node->getFCost();
+   
+   if (f > search.bound) {
+      if (f < search.nextBound) search.nextBound = f;
+      return false;
+   }
+   if (node->goalMatch()) {
+      return true;
+   }
+   
+   search.result.numOfStateExpansions++;
+   if (f <= search.previousBound) {
+      search.result.numOfAttemptedNodeReExpansions++; //already expanded by the previous iteration
+   }
+   if ((int)search.path.size() + 1 > search.result.maxQLength) {
+      search.result.maxQLength = (int)search.path.size() + 1; //deepest recursion, IDA* keeps no queue
+   }
+   
+   // Generate successors: Up, Right, Down, Left; g never exceeds the f bound, so it caps the depth too
+   const char moves[4] = {'U', 'R', 'D', 'L'};
+   for (int i = 0; i < 4; i++) {
+      char move = moves[i];
+      bool legal = false;
+      
+      switch (move) {
+         case 'U': legal = node->canMoveUp(search.bound); break;
+         case 'R': legal = node->canMoveRight(search.bound); break;
+         case 'D': legal = node->canMoveDown(search.bound); break;
+         case 'L': legal = node->canMoveLeft(search.bound); break;
+      }
+      if (!legal) continue;
+      
+      if (g_searchOptions.pruneParentMove && lastMove == inverseMove(move)) {
+         search.result.numOfLocalLoopsAvoided++;
+         continue;
+      }
+      
+      node->applyMove(move, search.heuristic);
+      search.result.numOfNodesGenerated++;
+      search.path.push_back(move);
+      
+      if (idaStarDepthFirst(search, move)) {
+         return true;
+      }
+      
+      search.path.pop_back();
+      node->undoMove(move, search.heuristic);
+   }
+   
+   return false;
+}
+
+template<class Puzzle>
+static SearchResult iterativeDeepeningAStarSearch(string const initialState, string const goalState, heuristicFunction heuristic){
+   
+   IDAStarSearch<Puzzle> search;
+   prepareTables<Puzzle>(goalState, heuristic == patternDatabase, search.result);
+   Stopwatch searchTime;
+   
+   Puzzle start(initialState, goalState);
+   start.updateHCost(heuristic);
+   start.updateFCost();
+   search.result.numOfNodeAllocations = 1;
+   search.result.peakNodeMemory = sizeof(Puzzle);
+   
+   search.node = &start;
+   search.heuristic = heuristic;
+   search.bound = start.getFCost();
+   search.previousBound = -1;
+   
+   bool found = false;
+   while (true) {
+      search.nextBound = NO_BOUND;
+      search.path.clear();
+      
+      found = idaStarDepthFirst(search, 0);
+      if (found || search.nextBound == NO_BOUND) break;
+      
+      search.previousBound = search.bound;
+      search.bound = search.nextBound;
+   }
+   
+   if (found) {
+      search.result.path = search.path;
+      search.result.pathLength = (int)search.path.size();
+   }
+   recordSearchTime(searchTime, search.result);
+   return search.result;
+}
+
+SearchResult iterativeDeepeningAStar(string const initialState, string const goalState, heuristicFunction heuristic){
+   boardSize size = boardSizeOf(initialState, goalState);
+   requireClassicBoard(size, heuristic == patternDatabase, "the pattern database heuristic");
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   switch (size) {
+      case board3x4: return iterativeDeepeningAStarSearch<BasicPuzzle<3, 4> >(initialState, goalState, heuristic);
+      case board4x4: return iterativeDeepeningAStarSearch<BasicPuzzle<4, 4> >(initialState, goalState, heuristic);
+      case board5x5: return iterativeDeepeningAStarSearch<BasicPuzzle<5, 5> >(initialState, goalState, heuristic);
+      default:       return iterativeDeepeningAStarSearch<Puzzle>(initialState, goalState, heuristic);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  Hash-distributed A* (HDA*)
+//
 // Move Generator:  
 //
 ////////////////////////////////////////////////////////////////////////////////////////////
-string aStar_ExpandedList(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
-                               float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic){
-                                 
-   string path;
-   clock_t startTime;
-   
-   numOfDeletionsFromMiddleOfHeap=0;
-   numOfLocalLoopsAvoided=0;
-   numOfAttemptedNodeReExpansions=0;
-   maxQLength=0;
-   numOfStateExpansions =0;
-   actualRunningTime=0.0;  
-   startTime = clock();
-   
-   // comparator for A* uses lower f-cost with tie breaking criteria that priositises larger g-cost
-   struct AStarComparator {
+
+//the thread that owns a state; the multiplicative hash spreads neighbouring states over all threads
+template<class State>
+static int ownerOf(State state, int numOfThreads) {
+   return (int)((((uint64_t)PuzzleStateHash()(state) * 0x9E3779B97F4A7C15ULL) >> 32) % (uint64_t)numOfThreads);
+}
+
+template<class Puzzle>
+struct HDAStarShared {
+   int numOfThreads;
+   vector<Mailbox<Puzzle> > mailboxes;         //one per thread, successors are posted to the owner of their state
+   heuristicFunction heuristic;
+   
+   atomic<int> incumbentCost;         //cost of the best solution found so far, nothing at or above it is searched
+   Puzzle *incumbent;
+   mutex incumbentLock;
+   
+   //threads still working plus letters posted but not yet collected; the search is over when it reaches 0
+   atomic<long> outstanding;
+   
+   HDAStarShared(int maxThreads, heuristicFunction h) : numOfThreads(maxThreads), mailboxes(maxThreads), heuristic(h),
+      incumbentCost(NO_BOUND), incumbent(NULL), outstanding(0) {}
+};
+
+//one thread's share of the search: its own open list, closed list and node storage
+template<class Puzzle>
+struct HDAStarWorker {
+   
+   typedef typename Puzzle::State State;
+   
+   struct HDAStarComparator {
       bool operator()(Puzzle *p1, Puzzle *p2) {
-         // Get f-costs
          int f1 = p1->getFCost();
          int f2 = p2->getFCost();
          
          if (f1 != f2) {
             return f1 > f2;
          }
-         int g1 = p1->getGCost();
-         int g2 = p2->getGCost();
-         return g1 < g2;
+         return p1->getGCost() < p2->getGCost();
       }
    };
    
-   // Initialise data structures
-   unordered_set<string> expandedList;
-   vector<Puzzle*> puzzleQueue;
+   int self;
+   HDAStarShared<Puzzle> *shared;
+   NodePool<Puzzle> pool;                               //outlives the parallel region, other threads' nodes point into it
+   deque<Letter<Puzzle> > letters;              //every letter this thread has posted
+   IndexedHeap<Puzzle, HDAStarComparator> puzzleQueue;
+   unordered_map<State, Puzzle*, PuzzleStateHash> reached; //best node per owned state, queued (heapIndex >= 0) or expanded
    
-   Puzzle *startPuzzle = new Puzzle(initialState, goalState);
-   startPuzzle->updateHCost(heuristic);
-   startPuzzle->updateFCost();
-   puzzleQueue.push_back(startPuzzle);
+   SearchResult result;                                 //this thread's counters, added up after the join
+   
+   HDAStarWorker() : self(0), shared(NULL) {}
    
-   while (!puzzleQueue.empty()) {
-      // Track maximum queue length
-      if ((int)puzzleQueue.size() > maxQLength) {
-         maxQLength = (int)puzzleQueue.size();
+   //takes a node for one of this thread's states into the open list, unless a path at least as short is known;
+   //a cheaper path to an expanded state reopens it, since threads do not expand in global f order
+   void admit(Puzzle *node, bool ownNode) {
+      State state = node->getState();
+      typename unordered_map<State, Puzzle*, PuzzleStateHash>::iterator it;
+      {
+         PROFILE_PHASE(result.phases, duplicateCheck);
+         it = reached.find(state);
       }
       
-      // Get node with lowest f-cost
-      pop_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-      Puzzle* current = puzzleQueue.back();
-      puzzleQueue.pop_back();
+      if (it == reached.end()) {
+         {
+            PROFILE_PHASE(result.phases, duplicateCheck);
+            reached[state] = node;
+         }
+         PROFILE_PHASE(result.phases, queuePush);
+         puzzleQueue.push(node);
+         result.numOfQueuePushes++;
+         return;
+      }
       
-      string currentState = current->toString();
+      Puzzle *known = it->second;
+      if (known->getGCost() <= node->getGCost()) {
+         if (known->getHeapIndex() < 0) result.numOfAttemptedNodeReExpansions++;
+         if (ownNode) pool.release(node);
+         return;
+      }
       
-      // Strict expanded list check
-      if (expandedList.find(currentState) != expandedList.end()) {
-         numOfAttemptedNodeReExpansions++;
-         delete current;
-         continue;
+      if (known->getHeapIndex() >= 0) {
+         PROFILE_PHASE(result.phases, queueReplace);
+         puzzleQueue.replace(known->getHeapIndex(), node); //the old node may belong to another thread's pool, so it is not released
+         result.numOfDeletionsFromMiddleOfHeap++;
+      } else {
+         PROFILE_PHASE(result.phases, queuePush);
+         puzzleQueue.push(node);
+         result.numOfQueuePushes++;
+      }
+      it->second = node;
+   }
+   
+   void offerSolution(Puzzle *goal, int cost) {
+      lock_guard<mutex> guard(shared->incumbentLock);
+      if (cost < shared->incumbentCost.load()) {
+         shared->incumbent = goal;
+         shared->incumbentCost.store(cost);
+      }
+   }
+   
+   void generate(Puzzle *current, Puzzle *successor) {
+      result.numOfNodesGenerated++;
+      {
+         PROFILE_PHASE(result.phases, heuristicEvaluation);
+         successor->updateHCost(shared->heuristic, *current);
+         successor->updateFCost();
       }
       
-      // Goal test
-      if (current->goalMatch()) {
-         path = current->getPath();
-         pathLength = current->getPathLength();
-         
-         // Clean up
-         delete current;
-         for (Puzzle* p : puzzleQueue) {
-            delete p;
-         }
-         
-         actualRunningTime = ((float)(clock() - startTime)/CLOCKS_PER_SEC);
-         return path;
+      if (successor->getFCost() >= shared->incumbentCost.load(memory_order_relaxed)) {
+         pool.release(successor);
+         return;
       }
       
-      // Add to expanded list
-      expandedList.insert(currentState);
-      numOfStateExpansions++;
+      int owner = ownerOf(successor->getState(), shared->numOfThreads);
+      if (owner == self) {
+         admit(successor, true);
+      } else {
+         Letter<Puzzle> letter = {successor, NULL};
+         letters.push_back(letter);
+         shared->outstanding++;
+         shared->mailboxes[owner].post(&letters.back());
+      }
+   }
+   
+   Puzzle *generateSuccessor(Puzzle *current, char move) {
+      PROFILE_PHASE(result.phases, successorGeneration);
+      return successorOf(current, move, pool);
+   }
+   
+   void expand(Puzzle *current) {
+      result.numOfStateExpansions++;
       
       // Generate successors: Up, Right, Down, Left
-      if (current->canMoveUp()) {
-         Puzzle* successor = current->moveUp();
-         string successorState = successor->toString();
-         
-         successor->updateHCost(heuristic);
-         successor->updateFCost();
-         
-         DuplicateResult dupResult = checkQueueForDuplicateParallel(puzzleQueue, successor, CompareType::F_COST);
-         
-         if (dupResult.found) {
-            if (dupResult.newIsBetter) {
-               // New path is better, remove old one from middle of heap
-               delete puzzleQueue[dupResult.index];
-               puzzleQueue.erase(puzzleQueue.begin() + dupResult.index);
-               numOfDeletionsFromMiddleOfHeap++;
-               make_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            } else {
-               // Old path is better or equal, discard new successor
-               delete successor;
-            }
-         } else {
-            // Not in queue, check if already expanded
-            if (expandedList.find(successorState) != expandedList.end()) {
-               numOfAttemptedNodeReExpansions++;
-               delete successor;
-            } else {
-               // State not in queue or expanded, add it
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            }
-         }
+      if (current->canMoveUp() && allowMove(current, 'U', result.numOfLocalLoopsAvoided)) {
+         generate(current, generateSuccessor(current, 'U'));
+      }
+      if (current->canMoveRight() && allowMove(current, 'R', result.numOfLocalLoopsAvoided)) {
+         generate(current, generateSuccessor(current, 'R'));
+      }
+      if (current->canMoveDown() && allowMove(current, 'D', result.numOfLocalLoopsAvoided)) {
+         generate(current, generateSuccessor(current, 'D'));
       }
+      if (current->canMoveLeft() && allowMove(current, 'L', result.numOfLocalLoopsAvoided)) {
+         generate(current, generateSuccessor(current, 'L'));
+      }
+   }
+   
+   void run() {
+      Stopwatch busy;
+      bool working = true; //counted in shared->outstanding while true
       
-      if (current->canMoveRight()) {
-         Puzzle* successor = current->moveRight();
-         string successorState = successor->toString();
-         
-         successor->updateHCost(heuristic);
-         successor->updateFCost();
-         
-         DuplicateResult dupResult = checkQueueForDuplicateParallel(puzzleQueue, successor, CompareType::F_COST);
-         
-         if (dupResult.found) {
-            if (dupResult.newIsBetter) {
-               delete puzzleQueue[dupResult.index];
-               puzzleQueue.erase(puzzleQueue.begin() + dupResult.index);
-               numOfDeletionsFromMiddleOfHeap++;
-               make_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            } else {
-               delete successor;
+      while (true) {
+         Letter<Puzzle> *mail = shared->mailboxes[self].collect();
+         if (mail != NULL) {
+            if (!working) {
+               shared->outstanding++;
+               working = true;
             }
-         } else {
-            if (expandedList.find(successorState) != expandedList.end()) {
-               numOfAttemptedNodeReExpansions++;
-               delete successor;
-            } else {
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
+            for (; mail != NULL; mail = mail->next) {
+               if (mail->node->getFCost() < shared->incumbentCost.load(memory_order_relaxed)) {
+                  admit(mail->node, false);
+               }
+               shared->outstanding--;
             }
          }
-      }
-      
-      if (current->canMoveDown()) {
-         Puzzle* successor = current->moveDown();
-         string successorState = successor->toString();
-         
-         successor->updateHCost(heuristic);
-         successor->updateFCost();
          
-         DuplicateResult dupResult = checkQueueForDuplicateParallel(puzzleQueue, successor, CompareType::F_COST);
+         if ((int)puzzleQueue.size() > result.maxQLength) {
+            result.maxQLength = (int)puzzleQueue.size();
+         }
          
-         if (dupResult.found) {
-            if (dupResult.newIsBetter) {
-               delete puzzleQueue[dupResult.index];
-               puzzleQueue.erase(puzzleQueue.begin() + dupResult.index);
-               numOfDeletionsFromMiddleOfHeap++;
-               make_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            } else {
-               delete successor;
+         // Nodes that cannot beat the incumbent are left in the queue and never looked at again
+         if (!puzzleQueue.empty() && puzzleQueue.at(0)->getFCost() < shared->incumbentCost.load(memory_order_relaxed)) {
+            Puzzle *current;
+            {
+               PROFILE_PHASE(result.phases, queuePop);
+               current = puzzleQueue.pop();
             }
-         } else {
-            if (expandedList.find(successorState) != expandedList.end()) {
-               numOfAttemptedNodeReExpansions++;
-               delete successor;
+            result.numOfQueuePops++;
+            
+            if (current->goalMatch()) {
+               offerSolution(current, current->getPathLength());
             } else {
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
+               expand(current);
             }
+            continue;
          }
-      }
-      
-      if (current->canMoveLeft()) {
-         Puzzle* successor = current->moveLeft();
-         string successorState = successor->toString();
-         
-         successor->updateHCost(heuristic);
-         successor->updateFCost();
          
-         DuplicateResult dupResult = checkQueueForDuplicateParallel(puzzleQueue, successor, CompareType::F_COST);
-         
-         if (dupResult.found) {
-            if (dupResult.newIsBetter) {
-               delete puzzleQueue[dupResult.index];
-               puzzleQueue.erase(puzzleQueue.begin() + dupResult.index);
-               numOfDeletionsFromMiddleOfHeap++;
-               make_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            } else {
-               delete successor;
-            }
-         } else {
-            if (expandedList.find(successorState) != expandedList.end()) {
-               numOfAttemptedNodeReExpansions++;
-               delete successor;
-            } else {
-               puzzleQueue.push_back(successor);
-               push_heap(puzzleQueue.begin(), puzzleQueue.end(), AStarComparator());
-            }
+         // Idle: nothing left here below the incumbent. Once no thread works and no letter is in
+         // flight, no thread can receive work again, so every thread sees 0 and stops.
+         if (working) {
+            working = false;
+            shared->outstanding--;
          }
+         if (shared->outstanding.load() == 0) {
+            break;
+         }
+         this_thread::yield();
+      }
+      result.searchCpuTimeNs = busy.cpuNanoseconds();
+   }
+};
+
+template<class Puzzle>
+static SearchResult hdaStarSearch(string const initialState, string const goalState, heuristicFunction heuristic){
+   
+   SearchResult result;
+   prepareTables<Puzzle>(goalState, heuristic == patternDatabase, result);
+   Stopwatch search;
+   
+   int maxThreads = (g_searchOptions.numOfThreads > 0) ? g_searchOptions.numOfThreads : omp_get_max_threads();
+   
+   HDAStarShared<Puzzle> shared(maxThreads, heuristic);
+   vector<HDAStarWorker<Puzzle> > workers(maxThreads); //kept after the join, the solution's parents live in their pools
+   NodePool<Puzzle> startPool;
+   
+   Puzzle *startPuzzle = startPool.create(Puzzle(initialState, goalState));
+   startPuzzle->updateHCost(heuristic);
+   startPuzzle->updateFCost();
+   Letter<Puzzle> startLetter = {startPuzzle, NULL};
+   
+   #pragma omp parallel num_threads(maxThreads)
+   {
+      // the runtime may start fewer threads than asked for; states are partitioned over those that run
+      #pragma omp single
+      {
+         shared.numOfThreads = omp_get_num_threads();
+         shared.outstanding = shared.numOfThreads + 1;
+         shared.mailboxes[ownerOf(startPuzzle->getState(), shared.numOfThreads)].post(&startLetter);
       }
       
-      delete current;
+      HDAStarWorker<Puzzle> &worker = workers[omp_get_thread_num()];
+      worker.self = omp_get_thread_num();
+      worker.shared = &shared;
+      worker.run();
    }
    
-   // if we dont find a solution we retuurn emppty string
-   actualRunningTime = ((float)(clock() - startTime)/CLOCKS_PER_SEC);
-   pathLength = 0;
-   return "";
-}
\ No newline at end of file
+   for (int i = 0; i < shared.numOfThreads; i++) {
+      const SearchResult &share = workers[i].result;
+      result.numOfStateExpansions += share.numOfStateExpansions;
+      result.maxQLength += share.maxQLength; //sum of the per-thread peaks
+      result.numOfDeletionsFromMiddleOfHeap += share.numOfDeletionsFromMiddleOfHeap;
+      result.numOfLocalLoopsAvoided += share.numOfLocalLoopsAvoided;
+      result.numOfAttemptedNodeReExpansions += share.numOfAttemptedNodeReExpansions;
+      result.numOfNodesGenerated += share.numOfNodesGenerated;
+      result.numOfQueuePushes += share.numOfQueuePushes;
+      result.numOfQueuePops += share.numOfQueuePops;
+      result.searchCpuTimeNs += share.searchCpuTimeNs;
+      result.phases.add(share.phases);
+      result.numOfNodeAllocations += (int)workers[i].pool.getNumOfAllocations();
+      result.peakNodeMemory += workers[i].pool.getNumOfBytes();
+      result.numOfExpansionsPerThread.push_back(share.numOfStateExpansions);
+   }
+   result.numOfNodeAllocations += (int)startPool.getNumOfAllocations();
+   result.peakNodeMemory += startPool.getNumOfBytes();
+   
+   if (shared.incumbent != NULL) {
+      result.path = shared.incumbent->getPath();
+      result.pathLength = shared.incumbent->getPathLength();
+   }
+   
+   long long cpuOfAllThreads = result.searchCpuTimeNs;
+   recordSearchTime(search, result);
+   result.searchCpuTimeNs = cpuOfAllThreads; //every worker's, the calling thread's alone would leave most out
+   return result;
+}
+
+SearchResult hdaStar(string const initialState, string const goalState, heuristicFunction heuristic){
+   boardSize size = boardSizeOf(initialState, goalState);
+   requireClassicBoard(size, heuristic == patternDatabase, "the pattern database heuristic");
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   switch (size) {
+      case board3x4: return hdaStarSearch<BasicPuzzle<3, 4> >(initialState, goalState, heuristic);
+      case board4x4: return hdaStarSearch<BasicPuzzle<4, 4> >(initialState, goalState, heuristic);
+      case board5x5: return hdaStarSearch<BasicPuzzle<5, 5> >(initialState, goalState, heuristic);
+      default:       return hdaStarSearch<Puzzle>(initialState, goalState, heuristic);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// Search Algorithm:  Distance oracle (no search)
+//
+// Move Generator:  greedy descent through a precomputed distance table
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+SearchResult distanceOracle_Search(string const initialState, string const goalState){
+   
+   boardSize size = boardSizeOf(initialState, goalState);
+   requireClassicBoard(size, true, "the distance oracle");
+   if (!solvablePair(size, initialState, goalState)) return SearchResult();
+   
+   SearchResult result;
+   
+   // the first call for a blank cell runs the backward breadth-first search that builds its table,
+   // reported as setup time; every goal with that blank cell shares it once the start is relabeled
+   Stopwatch setup;
+   const DistanceOracle *oracle = DistanceOracle::forGoal(goalState);
+   result.setupWallTimeNs = setup.wallNanoseconds();
+   result.setupCpuTimeNs = setup.cpuNanoseconds();
+   
+   Stopwatch search;
+   result.path = oracle->solve(relabelForGoal(stateFromString(initialState), stateFromString(goalState)));
+   
+   result.pathLength = (int)result.path.size();
+   result.numOfStateExpansions = result.pathLength; //one table probe round per step of the descent
+   recordSearchTime(search, result);
+   return result;
+}
@@ -11,18 +11,87 @@
 #include <vector>
 
 #include "puzzle.h" //optional only, may be removed
+#include "closedlist.h"
+#include "frontier.h"
+#include "phaseprofile.h"
 
 
+/////////////////////////////////////////////////////
+
+//Selects how a newly generated successor is checked against the states already waiting in the queue
+enum duplicateCheckMode{hashIndexLookup, parallelLinearScan};
+
+struct SearchOptions{
+    duplicateCheckMode duplicateCheck; //hashIndexLookup is O(1) per successor, parallelLinearScan is kept for comparison
+    closedListType closedList;         //storage of the strict expanded list
+    frontierType frontier;             //open list of uc_explist and aStar_ExpandedList
+    bool pruneParentMove;              //skip the successor that undoes the move into the node, counted in numOfLocalLoopsAvoided
+    int numOfThreads;                  //threads used by the parallel searches, 0 leaves it to OpenMP
+    int numOfBatchWorkers;             //searches solved side by side by batch_run, 0 means one per core
+
+    SearchOptions() : duplicateCheck(hashIndexLookup), closedList(hashSetClosedList), frontier(binaryHeapFrontier), pruneParentMove(true), numOfThreads(0), numOfBatchWorkers(0) {}
+};
+
+extern SearchOptions g_searchOptions;
+
+/////////////////////////////////////////////////////
+
+//Everything a search reports, returned by value. Counters a search has no use for stay 0.
+//A new metric is added here, filled in by the searches that track it, and gets one line in
+//main.cpp's resultColumns to show up in single_run and the batch tables.
+struct SearchResult{
+    string path;
+    int pathLength;                     //0 when no path was found
+    int numOfStateExpansions;
+    int maxQLength;
+    float actualRunningTime;            //seconds of wall time spent searching, setup excluded
+    int numOfDeletionsFromMiddleOfHeap;
+    int numOfLocalLoopsAvoided;
+    int numOfAttemptedNodeReExpansions;
+    int numOfNodeAllocations;
+    long numOfNodesGenerated;           //successors created, including those dropped as duplicates
+    long numOfQueuePushes;              //nodes put on the open list(s), decrease-key replacements not included
+    long numOfQueuePops;
+    long peakNodeMemory;                //bytes of node storage at the high-water mark
+    long long setupWallTimeNs;          //building or finding the goal's tables, the pattern database and the distance oracle
+    long long setupCpuTimeNs;
+    long long searchWallTimeNs;         //the search itself, the interval actualRunningTime reports
+    long long searchCpuTimeNs;          //searching thread only, except HDA* which adds up all of its threads
+    vector<int> numOfExpansionsPerThread; //parallel searches only
+    PhaseProfile phases;                //hot-path breakdown of UC, bidirectional UC, A* and HDA*; all 0 unless built with PROFILE_PHASES
+
+    SearchResult() : pathLength(0), numOfStateExpansions(0), maxQLength(0), actualRunningTime(0.0), numOfDeletionsFromMiddleOfHeap(0),
+        numOfLocalLoopsAvoided(0), numOfAttemptedNodeReExpansions(0), numOfNodeAllocations(0), numOfNodesGenerated(0),
+        numOfQueuePushes(0), numOfQueuePops(0), peakNodeMemory(0), setupWallTimeNs(0), setupCpuTimeNs(0), searchWallTimeNs(0), searchCpuTimeNs(0) {}
+};
+
 /////////////////////////////////////////////////////
 
 //Function prototypes
 
-string uc_explist(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
-                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions);
+//every search takes its states in any format parseBoard() accepts, on 3x3, 3x4, 4x4 or 5x5 boards
+//(both states the same size); anything else throws invalid_argument, as do the 3x3-only tables
+//(--closed-list=bitset, the pattern database and the distance oracle) on larger boards
+
+SearchResult uc_explist(string const initialState, string const goalState);
+
+
+//UC grown from both ends at once; stops when the two cheapest queued nodes cannot beat the best meeting path
+SearchResult uc_bidirectional(string const initialState, string const goalState);
+
+
+SearchResult aStar_ExpandedList(string const initialState, string const goalState, heuristicFunction heuristic);
+
+
+//IDA*: depth-first with an f bound, memory stays O(depth); maxQLength reports the deepest recursion
+SearchResult iterativeDeepeningAStar(string const initialState, string const goalState, heuristicFunction heuristic);
 
+//HDA*: A* spread over threads, each owning the states that hash to it and trading successors through
+//lock-free mailboxes; expansions are also reported per thread
+SearchResult hdaStar(string const initialState, string const goalState, heuristicFunction heuristic);
 
-string aStar_ExpandedList(string const initialState, string const goalState, int& pathLength, int &numOfStateExpansions, int& maxQLength,
-                          float &actualRunningTime, int &numOfDeletionsFromMiddleOfHeap, int &numOfLocalLoopsAvoided, int &numOfAttemptedNodeReExpansions, heuristicFunction heuristic);
+//looks the answer up in a per-goal table of exact distances, built on first use by one backward BFS
+SearchResult distanceOracle_Search(string const initialState, string const goalState);
 
 
 
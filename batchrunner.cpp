@@ -0,0 +1,124 @@
+#include "batchrunner.h"
+
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+//the parallel searches would compete with the batch workers for the same cores
+static bool isParallelSearch(const string& algorithm){
+	return algorithm.compare(0, 8, "hdastar_") == 0;
+}
+
+bool runBatchJob(const BatchJob& job, SearchResult& r){
+	const string& a = job.algorithm;
+
+	if(a == "uc_explist"){
+		r = uc_explist(job.initialState, job.goalState);
+	}else if(a == "uc_bidirectional"){
+		r = uc_bidirectional(job.initialState, job.goalState);
+	}else if(a == "astar_explist_misplacedtiles"){
+		r = aStar_ExpandedList(job.initialState, job.goalState, misplacedTiles);
+	}else if(a == "astar_explist_manhattan"){
+		r = aStar_ExpandedList(job.initialState, job.goalState, manhattanDistance);
+	}else if(a == "astar_explist_pdb"){
+		r = aStar_ExpandedList(job.initialState, job.goalState, patternDatabase);
+	}else if(a == "astar_explist_linearconflict"){
+		r = aStar_ExpandedList(job.initialState, job.goalState, linearConflict);
+	}else if(a == "idastar_misplacedtiles"){
+		r = iterativeDeepeningAStar(job.initialState, job.goalState, misplacedTiles);
+	}else if(a == "idastar_manhattan"){
+		r = iterativeDeepeningAStar(job.initialState, job.goalState, manhattanDistance);
+	}else if(a == "distance_oracle"){
+		r = distanceOracle_Search(job.initialState, job.goalState);
+	}else if(a == "hdastar_misplacedtiles"){
+		r = hdaStar(job.initialState, job.goalState, misplacedTiles);
+	}else if(a == "hdastar_manhattan"){
+		r = hdaStar(job.initialState, job.goalState, manhattanDistance);
+	}else{
+		return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////
+//work-stealing scheduler
+//////////////////////////////////////////////////////////////
+struct WorkQueue{
+	mutex lock;
+	deque<int> jobs; //indices into the batch
+};
+
+//next job for worker 'self': its own newest job, else the oldest job of another worker; -1 when all are empty.
+//No jobs are added once the workers start, so one empty sweep means the batch is done.
+static int nextJob(vector<WorkQueue>& queues, int self){
+	int n = (int)queues.size();
+
+	{
+		lock_guard<mutex> guard(queues[self].lock);
+		if(!queues[self].jobs.empty()){
+			int job = queues[self].jobs.back();
+			queues[self].jobs.pop_back();
+			return job;
+		}
+	}
+	for(int k=1; k < n; k++){
+		WorkQueue& victim = queues[(self + k) % n];
+		lock_guard<mutex> guard(victim.lock);
+		if(!victim.jobs.empty()){
+			int job = victim.jobs.front();
+			victim.jobs.pop_front();
+			return job;
+		}
+	}
+	return -1;
+}
+
+vector<SearchResult> runBatch(const vector<BatchJob>& jobs, int numOfWorkers){
+	vector<SearchResult> results(jobs.size());
+
+	if(numOfWorkers <= 0) numOfWorkers = (int)thread::hardware_concurrency();
+	if(numOfWorkers <= 0) numOfWorkers = 1;
+
+	vector<WorkQueue> queues(numOfWorkers);
+	vector<int> exclusive;
+	int dealt = 0;
+
+	for(int i=0; i < (int)jobs.size(); i++){
+		if(isParallelSearch(jobs[i].algorithm)){
+			exclusive.push_back(i);
+		}else{
+			queues[dealt++ % numOfWorkers].jobs.push_back(i);
+		}
+	}
+
+	//a job that throws (e.g. a board no search is compiled for) stops its worker; the first
+	//such error is passed on to the caller once every worker has finished
+	vector<exception_ptr> errors(numOfWorkers);
+	vector<thread> workers;
+	for(int w=0; w < numOfWorkers; w++){
+		workers.push_back(thread([&queues, &jobs, &results, &errors, w](){
+			try{
+				int job;
+				while((job = nextJob(queues, w)) >= 0){
+					runBatchJob(jobs[job], results[job]);
+				}
+			}catch(...){
+				errors[w] = current_exception();
+			}
+		}));
+	}
+	for(size_t w=0; w < workers.size(); w++){
+		workers[w].join();
+	}
+	for(size_t w=0; w < errors.size(); w++){
+		if(errors[w]) rethrow_exception(errors[w]);
+	}
+
+	for(size_t k=0; k < exclusive.size(); k++){
+		runBatchJob(jobs[exclusive[k]], results[exclusive[k]]);
+	}
+	return results;
+}
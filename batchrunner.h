@@ -0,0 +1,38 @@
+#ifndef __BATCHRUNNER_H__
+#define __BATCHRUNNER_H__
+
+#include <string>
+#include <vector>
+
+#include "algorithm.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Parallel batch execution of (algorithm, instance) jobs.
+//
+// Jobs are dealt round-robin to one deque per worker thread. A worker
+// takes its own jobs from the back and, once it runs dry, steals from the
+// front of the other deques, so a few long searches do not leave the
+// remaining cores idle. Each result is stored at its job's index, so the
+// output order does not depend on the schedule.
+//
+/////////////////////////////////////////////////////
+
+struct BatchJob{
+    string algorithm;     //command-line name, e.g. "astar_explist_manhattan"
+    string label;         //name printed in the ALGORITHM column
+    string initialState;
+    string goalState;
+};
+
+//runs the search named by job.algorithm; false if there is no such algorithm
+bool runBatchJob(const BatchJob& job, SearchResult& result);
+
+//solves every job on numOfWorkers threads (0: one per core) and returns result i for job i;
+//searches that are parallel themselves run one at a time on the calling thread afterwards.
+//An exception thrown by a job is rethrown here once all workers have stopped.
+vector<SearchResult> runBatch(const vector<BatchJob>& jobs, int numOfWorkers);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __CLOSEDLIST_H__
+#define __CLOSEDLIST_H__
+
+#include <vector>
+#include <unordered_set>
+
+#include "puzzle.h"
+#include "permutation.h"
+
+using namespace std;
+
+//Selects how the strict expanded list is stored
+enum closedListType{hashSetClosedList, rankBitsetClosedList};
+
+/////////////////////////////////////////////////////
+//
+// Strict expanded list, one class per closedListType; the search engine
+// takes the class as a template parameter.
+//
+// HashClosedList keeps the expanded states in an unordered_set.
+// RankBitsetClosedList keeps one bit per reachable state, indexed by
+// rankState(), which is 9!/2 bits (~23 KB) no matter how much of the
+// state space is expanded. It only exists for the 3x3 board; the searches
+// refuse it for any other size.
+//
+/////////////////////////////////////////////////////
+
+template <class State>
+class HashClosedList{
+
+private:
+
+    unordered_set<State, PuzzleStateHash> hashed;
+
+public:
+
+    bool contains(State state) const {
+        return hashed.find(state) != hashed.end();
+    }
+
+    void insert(State state){
+        hashed.insert(state);
+    }
+};
+
+template <class State>
+class RankBitsetClosedList{
+
+private:
+
+    vector<uint64_t> bits;
+
+public:
+
+    RankBitsetClosedList() : bits((NUM_REACHABLE_STATES + 63) / 64, 0) {}
+
+    bool contains(State state) const {
+        int rank = rankState((PuzzleState)state);
+        return (bits[rank >> 6] >> (rank & 63)) & 1;
+    }
+
+    void insert(State state){
+        int rank = rankState((PuzzleState)state);
+        bits[rank >> 6] |= (uint64_t)1 << (rank & 63);
+    }
+};
+
+#endif
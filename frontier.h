@@ -0,0 +1,227 @@
+#ifndef __FRONTIER_H__
+#define __FRONTIER_H__
+
+#include <vector>
+
+#include "puzzle.h"
+
+using namespace std;
+
+//Selects how uc_explist and aStar_ExpandedList keep their open list:
+//IndexedHeap or BucketQueue, given to the search engine as a template parameter
+enum frontierType{binaryHeapFrontier, bucketQueueFrontier};
+
+/////////////////////////////////////////////////////
+//
+// Indexed binary heap of search nodes.
+//
+// Every node records its own slot (BasicPuzzle::heapIndex), so a node can be
+// found, re-prioritised (decrease-key) or removed from the middle of the
+// heap in O(log n) without rebuilding the whole heap.
+//
+// Compare follows the std::push_heap convention: Compare()(a, b) is true
+// when a has LOWER priority than b.
+//
+/////////////////////////////////////////////////////
+
+template <class Node, class Compare>
+class IndexedHeap{
+
+private:
+
+    vector<Node*> heap;
+    Compare lowerPriority;
+
+    void place(int index, Node *p){
+        heap[index] = p;
+        p->setHeapIndex(index);
+    }
+
+    void siftUp(int index){
+        Node *p = heap[index];
+        while(index > 0){
+            int parent = (index - 1) / 2;
+            if(!lowerPriority(heap[parent], p)) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, p);
+    }
+
+    void siftDown(int index){
+        Node *p = heap[index];
+        int n = (int)heap.size();
+        while(true){
+            int child = 2 * index + 1;
+            if(child >= n) break;
+            if(child + 1 < n && lowerPriority(heap[child], heap[child + 1])) child++;
+            if(!lowerPriority(p, heap[child])) break;
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, p);
+    }
+
+public:
+
+    bool empty() const { return heap.empty(); }
+    int size() const { return (int)heap.size(); }
+
+    Node *at(int index) const { return heap[index]; }
+
+    //direct access to the slots, e.g. for linear scans and clean-up
+    vector<Node*>& items(){ return heap; }
+
+    void push(Node *p){
+        heap.push_back(p);
+        siftUp((int)heap.size() - 1);
+    }
+
+    Node *pop(){
+        Node *top = heap[0];
+        Node *last = heap.back();
+        heap.pop_back();
+        if(!heap.empty()){
+            place(0, last);
+            siftDown(0);
+        }
+        top->setHeapIndex(-1);
+        return top;
+    }
+
+    //restores heap order after the key of the node at index has changed
+    void update(int index){
+        Node *p = heap[index];
+        siftUp(index);
+        siftDown(p->getHeapIndex());
+    }
+
+    //decrease-key by substitution: p takes over the slot of the node at index,
+    //which is returned to the caller
+    Node *replace(int index, Node *p){
+        Node *old = heap[index];
+        place(index, p);
+        old->setHeapIndex(-1);
+        update(index);
+        return old;
+    }
+
+    Node *replace(Node *old, Node *p){
+        return replace(old->getHeapIndex(), p);
+    }
+
+    //removes and returns the node at an arbitrary slot
+    Node *remove(int index){
+        Node *old = heap[index];
+        Node *last = heap.back();
+        heap.pop_back();
+        if(index < (int)heap.size()){
+            place(index, last);
+            update(index);
+        }
+        old->setHeapIndex(-1);
+        return old;
+    }
+};
+
+/////////////////////////////////////////////////////
+//
+// Bucket queue of search nodes for small non-negative integer keys.
+//
+// Order supplies two keys per node: Order::key() (popped lowest first)
+// and Order::tieKey() (popped highest first among equal keys), e.g. f and
+// g for A*, which gives the same order as its heap comparator. Nodes
+// sit in one list per (key, tieKey) and record their slot in that list
+// as heapIndex, so push, pop and removal from the middle are O(1) apart
+// from skipping empty lists.
+//
+/////////////////////////////////////////////////////
+
+template <class Node, class Order>
+class BucketQueue{
+
+private:
+
+    struct Bucket{
+        vector<vector<Node*> > lists; //[tieKey]
+        int count;
+        int top; //no list above this one holds a node
+
+        Bucket() : count(0), top(-1) {}
+    };
+
+    vector<Bucket> buckets; //[key]
+    int lowest;             //no bucket below this one holds a node
+    int count;
+    vector<Node*> snapshot;
+
+public:
+
+    BucketQueue() : lowest(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    void push(Node *p){
+        int key = Order::key(p);
+        int tie = Order::tieKey(p);
+
+        if(key >= (int)buckets.size()) buckets.resize(key + 1);
+        Bucket &bucket = buckets[key];
+        if(tie >= (int)bucket.lists.size()) bucket.lists.resize(tie + 1);
+
+        p->setHeapIndex((int)bucket.lists[tie].size());
+        bucket.lists[tie].push_back(p);
+        bucket.count++;
+        if(tie > bucket.top) bucket.top = tie;
+        if(key < lowest || count == 0) lowest = key;
+        count++;
+    }
+
+    Node *pop(){
+        while(buckets[lowest].count == 0) lowest++;
+        Bucket &bucket = buckets[lowest];
+        while(bucket.lists[bucket.top].empty()) bucket.top--;
+
+        Node *top = bucket.lists[bucket.top].back();
+        bucket.lists[bucket.top].pop_back();
+        bucket.count--;
+        count--;
+        top->setHeapIndex(-1);
+        return top;
+    }
+
+    //removes a queued node; the last node of its list takes over its slot
+    void remove(Node *p){
+        Bucket &bucket = buckets[Order::key(p)];
+        vector<Node*> &list = bucket.lists[Order::tieKey(p)];
+        Node *last = list.back();
+
+        list[p->getHeapIndex()] = last;
+        last->setHeapIndex(p->getHeapIndex());
+        list.pop_back();
+        bucket.count--;
+        count--;
+        p->setHeapIndex(-1);
+    }
+
+    //decrease-key by substitution: old leaves the queue, p joins it; old is returned to the caller
+    Node *replace(Node *old, Node *p){
+        remove(old);
+        push(p);
+        return old;
+    }
+
+    //every queued node in no particular order, copied out for linear scans; O(n)
+    vector<Node*>& items(){
+        snapshot.clear();
+        for(size_t key=0; key < buckets.size(); key++){
+            for(size_t tie=0; tie < buckets[key].lists.size(); tie++){
+                snapshot.insert(snapshot.end(), buckets[key].lists[tie].begin(), buckets[key].lists[tie].end());
+            }
+        }
+        return snapshot;
+    }
+};
+
+#endif
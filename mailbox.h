@@ -0,0 +1,57 @@
+#ifndef __MAILBOX_H__
+#define __MAILBOX_H__
+
+#include <atomic>
+#include <cstddef>
+
+#include "puzzle.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Lock-free multi-producer, single-consumer mailbox of search nodes.
+//
+// Any thread may post a letter (a compare-and-swap push onto an intrusive
+// stack); only the owner collects, and it always takes the whole stack in
+// one exchange, so no letter is ever unlinked on its own and the ABA
+// problem cannot arise. Letters live in the sender's storage and are never
+// reused during a search, so the receiver may read them freely.
+//
+/////////////////////////////////////////////////////
+
+template <class Node>
+struct Letter{
+    Node *node;
+    Letter<Node> *next;
+};
+
+template <class Node>
+class Mailbox{
+
+private:
+
+    atomic<Letter<Node>*> head;
+    char padding[64 - sizeof(atomic<Letter<Node>*>)]; //one mailbox per cache line, posts to neighbours don't collide
+
+    Mailbox(const Mailbox&); //not copyable
+
+public:
+
+    Mailbox() : head(NULL) {}
+
+    void post(Letter<Node> *letter){
+        Letter<Node> *top = head.load(memory_order_relaxed);
+        do{
+            letter->next = top;
+        }while(!head.compare_exchange_weak(top, letter, memory_order_release, memory_order_relaxed));
+    }
+
+    //takes every letter posted so far, newest first; NULL when there are none
+    Letter<Node> *collect(){
+        if(head.load(memory_order_relaxed) == NULL) return NULL;
+        return head.exchange(NULL, memory_order_acquire);
+    }
+};
+
+#endif
@@ -27,17 +27,25 @@
 
 #if defined __unix__ || defined __APPLE__
 
+#ifndef HEADLESS
     #include <graphics.h>
+#endif
 
     #include "algorithm.h"
+    #include "batchrunner.h"
+    #include "patterndb.h"
 
 #elif defined __WIN32__
 
     #include <windows.h>
 
 
+#ifndef HEADLESS
     #include "graphics.h"
+#endif
     #include "algorithm.h"
+    #include "batchrunner.h"
+    #include "patterndb.h"
 
 #endif
 
@@ -52,6 +60,8 @@ int g_local_loops_avoided;
 
 #define OUTPUT_LENGTH 2 /* Length of output string. */
 
+#ifndef HEADLESS //built without a graphics library: solver only, no animate_run
+
 const int HEIGHT = 400; /**< Height of board for rendering in pixels. */
 const int WIDTH  = 400; /**< Width of board for rendering in pixels. */
 
@@ -300,279 +310,220 @@ void AnimateSolution(string const initialState, string const goalState, string p
 
 }
 
+// Opens the window for animate_run; batch and single runs never touch the graphics library
+void openGraphicsWindow() {
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-void run_all_experiments() {
-
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
+#if defined __unix__ || defined __APPLE__
+    // init graphics
+    int GraphDriver=DETECT,GraphMode;
+    initgraph( &GraphDriver, &GraphMode, const_cast<char*>("") ); // Start Window
 
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
+#elif defined __WIN32__    
+    // init graphics
+    int graphDriver = 0;
+    int graphMode = 0;
+    initgraph(&graphDriver, &graphMode, "", WIDTH, HEIGHT);   
+#endif
 
-    string initialState;
+}
 
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH,  COMMENTS" << endl;
+#endif //HEADLESS
 
-    //---
-    for (int j = 0; j < num_of_init_states; j++) {
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
-
-
-        std::cout << setw(21) << "uniform_cost_search";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Queues one job per initial state for the given algorithm
+void add_experiments(vector<BatchJob>& jobs, string const algorithm, string const label) {
 
+    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
 
-    } //End - For loop
-    //---
     for (int j = 0; j < num_of_init_states; j++) {
+        BatchJob job;
+        job.algorithm = algorithm;
+        job.label = label;
+        job.initialState = list_of_initialStates[j];
+        job.goalState = goalState;
+        jobs.push_back(job);
+    }
+}
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
-
-                                  
-        std::cout << setw(21) << "astar_misplacedtiles";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
-
-
-     } //End - For loop
-    //---
-    for (int j = 0; j < num_of_init_states; j++) {
+///////////////////////////////////////////////////////////////////////////////////////////////
+// The metrics shown for every search, in output order: the CSV column header, the single_run
+// label (NULL: batch tables only) and the padding before the value in a single algorithm's batch table.
+// A new SearchResult metric needs one line here.
+struct ResultColumn {
+    const char *header;
+    const char *label;
+    int width;
+    void (*print)(ostream &out, const SearchResult &r);
+};
+
+template<int PHASE> static void printPhaseCalls(ostream &out, const SearchResult &r) { out << r.phases.calls[PHASE]; }
+template<int PHASE> static void printPhaseCycles(ostream &out, const SearchResult &r) { out << r.phases.cycles[PHASE]; }
+
+static const ResultColumn resultColumns[] = {
+    {"PATH_LENGTH",            "Path Length:",                       10, [](ostream &out, const SearchResult &r) { out << r.pathLength; }},
+    {"STATE_EXPANSIONS",       "Num Of State Expansions:",           13, [](ostream &out, const SearchResult &r) { out << r.numOfStateExpansions; }},
+    {"MAX_QLENGTH",            "Max Q Length:",                      15, [](ostream &out, const SearchResult &r) { out << r.maxQLength; }},
+    {"RUNNING_TIME",           "Actual Running Time:",               15, [](ostream &out, const SearchResult &r) { out << r.actualRunningTime; }},
+    {"DELETIONS_MIDDLE_HEAP",  "Num of Deletions from MiddleOfHeap:", 15, [](ostream &out, const SearchResult &r) { out << r.numOfDeletionsFromMiddleOfHeap; }},
+    {"LOCAL_LOOPS_AVOIDED",    "Num of Local Loops Avoided:",         20, [](ostream &out, const SearchResult &r) { out << r.numOfLocalLoopsAvoided; }},
+    {"ATTEMPTED_REEXPANSIONS", "Num of Attempted Node ReExpansions:", 15, [](ostream &out, const SearchResult &r) { out << r.numOfAttemptedNodeReExpansions; }},
+    {"NODE_ALLOCATIONS",       "Num of Node Allocations:",           15, [](ostream &out, const SearchResult &r) { out << r.numOfNodeAllocations; }},
+    {"NODES_GENERATED",        "Num of Nodes Generated:",            15, [](ostream &out, const SearchResult &r) { out << r.numOfNodesGenerated; }},
+    {"QUEUE_PUSHES",           "Num of Queue Pushes:",               15, [](ostream &out, const SearchResult &r) { out << r.numOfQueuePushes; }},
+    {"QUEUE_POPS",             "Num of Queue Pops:",                 15, [](ostream &out, const SearchResult &r) { out << r.numOfQueuePops; }},
+    {"PEAK_NODE_MEMORY",       "Peak Node Memory (bytes):",          15, [](ostream &out, const SearchResult &r) { out << r.peakNodeMemory; }},
+    {"SETUP_WALL_NS",          "Setup Wall Time (ns):",              15, [](ostream &out, const SearchResult &r) { out << r.setupWallTimeNs; }},
+    {"SETUP_CPU_NS",           "Setup CPU Time (ns):",               15, [](ostream &out, const SearchResult &r) { out << r.setupCpuTimeNs; }},
+    {"SEARCH_WALL_NS",         "Search Wall Time (ns):",             15, [](ostream &out, const SearchResult &r) { out << r.searchWallTimeNs; }},
+    {"SEARCH_CPU_NS",          "Search CPU Time (ns):",              15, [](ostream &out, const SearchResult &r) { out << r.searchCpuTimeNs; }},
+#ifdef PROFILE_PHASES
+    // single_run prints these as a table of its own, see printPhaseProfile()
+    {"SUCCESSOR_CALLS",        NULL,                                 15, printPhaseCalls<successorGeneration>},
+    {"SUCCESSOR_CYCLES",       NULL,                                 15, printPhaseCycles<successorGeneration>},
+    {"HEURISTIC_CALLS",        NULL,                                 15, printPhaseCalls<heuristicEvaluation>},
+    {"HEURISTIC_CYCLES",       NULL,                                 15, printPhaseCycles<heuristicEvaluation>},
+    {"CLOSED_LIST_CALLS",      NULL,                                 15, printPhaseCalls<closedListLookup>},
+    {"CLOSED_LIST_CYCLES",     NULL,                                 15, printPhaseCycles<closedListLookup>},
+    {"DUPLICATE_CHECK_CALLS",  NULL,                                 15, printPhaseCalls<duplicateCheck>},
+    {"DUPLICATE_CHECK_CYCLES", NULL,                                 15, printPhaseCycles<duplicateCheck>},
+    {"QUEUE_PUSH_CALLS",       NULL,                                 15, printPhaseCalls<queuePush>},
+    {"QUEUE_PUSH_CYCLES",      NULL,                                 15, printPhaseCycles<queuePush>},
+    {"QUEUE_POP_CALLS",        NULL,                                 15, printPhaseCalls<queuePop>},
+    {"QUEUE_POP_CYCLES",       NULL,                                 15, printPhaseCycles<queuePop>},
+    {"QUEUE_REPLACE_CALLS",    NULL,                                 15, printPhaseCalls<queueReplace>},
+    {"QUEUE_REPLACE_CYCLES",   NULL,                                 15, printPhaseCycles<queueReplace>},
+#endif
+};
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance);
-
-                                  
-        std::cout << setw(21) << "astar_manhattan";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << path << endl;
+static const int NUM_OF_RESULT_COLUMNS = sizeof(resultColumns) / sizeof(resultColumns[0]);
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+// single_run's breakdown of the search's hot path, only filled in when built with PROFILE_PHASES
+void printPhaseProfile(const PhaseProfile &profile) {
 
-    } //End - For loop
+    long long profiledCycles = 0;
+    for (int p = 0; p < NUM_OF_SEARCH_PHASES; p++) {
+        profiledCycles += profile.cycles[p];
+    }
 
+    cout << endl << setw(25) << std::right << "Phase" << setw(13) << "Calls" << setw(16) << "Cycles" << setw(13) << "Cycles/Call" << setw(9) << "Share" << endl;
+    for (int p = 0; p < NUM_OF_SEARCH_PHASES; p++) {
+        long long calls = profile.calls[p];
+        long long cycles = profile.cycles[p];
+        cout << setw(25) << std::right << phaseName(p) << setw(13) << calls << setw(16) << cycles;
+        cout << std::fixed << setprecision(1) << setw(13) << (calls > 0 ? (double)cycles / calls : 0.0);
+        cout << setw(8) << (profiledCycles > 0 ? 100.0 * cycles / profiledCycles : 0.0) << "%" << endl;
+    }
+    cout << setprecision(6);
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////////////////////
-void run_uc_experiments() {
+// Prints one CSV row per job; columnWidth 0 pads each column by its own width
+void print_results(const vector<BatchJob>& jobs, const vector<SearchResult>& results, int labelWidth, int columnWidth, bool withComments) {
 
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
-
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
-
-    string initialState;
-
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
+    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE";
+    for (int c = 0; c < NUM_OF_RESULT_COLUMNS; c++) {
+        std::cout << ",     " << resultColumns[c].header;
+    }
+    std::cout << ",   PATH" << (withComments ? ",  COMMENTS" : "") << endl;
 
-    for (int j = 0; j < num_of_init_states; j++) {
+    for (size_t j = 0; j < jobs.size(); j++) {
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
-
-
-        std::cout << setw(16) << "uniform_cost_search";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
+        const SearchResult& r = results[j];
 
+        std::cout << setw(labelWidth) << jobs[j].label;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << jobs[j].initialState;
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << jobs[j].goalState;
+        for (int c = 0; c < NUM_OF_RESULT_COLUMNS; c++) {
+            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(columnWidth > 0 ? columnWidth : resultColumns[c].width) << ",";
+            resultColumns[c].print(std::cout, r);
+        }
+        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(columnWidth > 0 ? columnWidth : 15) << "," << r.path << endl;
 
     } //End - For loop
 
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
-void run_astar_manhattan_experiments() {
-
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
-
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
-
-    string initialState; 
-
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
-
-    for (int j = 0; j < num_of_init_states; j++) {
+void run_all_experiments() {
 
-            initialState = list_of_initialStates[j];
+    vector<BatchJob> jobs;
 
-            string path;
-            path.clear();
-            pathLength = 0;
-            // depth = 0;
-            numOfStateExpansions = 0;
-            maxQLength = 0;
-            numOfDeletionsFromMiddleOfHeap = 0;
-            numOfLocalLoopsAvoided = 0;
-            numOfAttemptedNodeReExpansions = 0;
-            actualRunningTime = 0.0;
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, manhattanDistance);
+    add_experiments(jobs, "uc_explist", "uniform_cost_search");
+    add_experiments(jobs, "uc_bidirectional", "uc_bidirectional");
+    add_experiments(jobs, "astar_explist_misplacedtiles", "astar_misplacedtiles");
+    add_experiments(jobs, "astar_explist_manhattan", "astar_manhattan");
+    add_experiments(jobs, "astar_explist_linearconflict", "astar_linearconflict");
+    add_experiments(jobs, "astar_explist_pdb", "astar_pdb");
+    add_experiments(jobs, "idastar_misplacedtiles", "idastar_misplacedtiles");
+    add_experiments(jobs, "idastar_manhattan", "idastar_manhattan");
+    add_experiments(jobs, "distance_oracle", "distance_oracle");
+    add_experiments(jobs, "hdastar_misplacedtiles", "hdastar_misplacedtiles");
+    add_experiments(jobs, "hdastar_manhattan", "hdastar_manhattan");
 
-            
-            std::cout << setw(16) << "astar_manhattan";
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-            std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
-            
+    vector<SearchResult> results = runBatch(jobs, g_searchOptions.numOfBatchWorkers);
 
-    } //End - For loop
+    print_results(jobs, results, 21, 10, true);
 
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
-void run_astar_misplaced_tiles_experiments() {
+// Batch run of a single algorithm over all initial states
+void run_experiments(string const algorithm, string const label) {
 
-    int num_of_init_states = sizeof(list_of_initialStates) / sizeof(list_of_initialStates[0]);
+    vector<BatchJob> jobs;
 
-    int pathLength = 0;
-    // int depth = 0;
-    int numOfStateExpansions = 0;
-    int maxQLength = 0;
-    int numOfDeletionsFromMiddleOfHeap = 0;
-    int numOfLocalLoopsAvoided = 0;
-    int numOfAttemptedNodeReExpansions = 0;
-    float actualRunningTime = 0.0;
+    add_experiments(jobs, algorithm, label);
 
-    string initialState;
+    vector<SearchResult> results = runBatch(jobs, g_searchOptions.numOfBatchWorkers);
 
-    std::cout << "ALGORITHM,               INIT_STATE,            GOAL_STATE,       PATH_LENGTH,     STATE_EXPANSIONS,  MAX_QLENGTH,  RUNNING_TIME,  DELETIONS_MIDDLE_HEAP, LOCAL_LOOPS_AVOIDED, ATTEMPTED_REEXPANSIONS,   PATH" << endl;
+    print_results(jobs, results, 16, 0, false);
 
-    for (int j = 0; j < num_of_init_states; j++) {
+}
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Removes the optional "--name=value" switches from argv, applies them to g_searchOptions
+// and returns the number of remaining positional arguments.
+int extractSearchOptions(int argc, char* argv[]) {
 
-        initialState = list_of_initialStates[j];
-
-        string path;
-        path.clear();
-        pathLength = 0;
-        // depth = 0;
-        numOfStateExpansions = 0;
-        maxQLength = 0;
-        numOfDeletionsFromMiddleOfHeap = 0;
-        numOfLocalLoopsAvoided = 0;
-        numOfAttemptedNodeReExpansions = 0;
-        actualRunningTime = 0.0;
-        path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
-
-
-        std::cout << setw(16) << "astar_misplacedtiles";
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << initialState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << goalState;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(10) << "," << pathLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(13) << "," << numOfStateExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << maxQLength;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << actualRunningTime;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfDeletionsFromMiddleOfHeap;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(20) << "," << numOfLocalLoopsAvoided;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << numOfAttemptedNodeReExpansions;
-        std::cout << setprecision(6) << std::setfill(' ') << std::fixed << std::right << ' ' << setw(15) << "," << path << endl;
+    int positional = 1;
 
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
 
-    } //End - For loop
+        if (arg.compare(0, 2, "--") != 0) {
+            argv[positional++] = argv[i];
+            continue;
+        }
+
+        if (arg == "--duplicate-check=hash") {
+            g_searchOptions.duplicateCheck = hashIndexLookup;
+        } else if (arg == "--duplicate-check=scan") {
+            g_searchOptions.duplicateCheck = parallelLinearScan;
+        } else if (arg == "--closed-list=hash") {
+            g_searchOptions.closedList = hashSetClosedList;
+        } else if (arg == "--closed-list=bitset") {
+            g_searchOptions.closedList = rankBitsetClosedList;
+        } else if (arg == "--frontier=heap") {
+            g_searchOptions.frontier = binaryHeapFrontier;
+        } else if (arg == "--frontier=buckets") {
+            g_searchOptions.frontier = bucketQueueFrontier;
+        } else if (arg == "--parent-pruning=on") {
+            g_searchOptions.pruneParentMove = true;
+        } else if (arg == "--parent-pruning=off") {
+            g_searchOptions.pruneParentMove = false;
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            g_searchOptions.numOfThreads = atoi(arg.c_str() + 10);
+        } else if (arg.compare(0, 16, "--batch-workers=") == 0) {
+            g_searchOptions.numOfBatchWorkers = atoi(arg.c_str() + 16);
+        } else if (arg.compare(0, 11, "--pdb-file=") == 0) {
+            PatternDatabase::setFileName(arg.substr(11));
+        } else {
+            cout << "ignoring unknown option " << arg << endl;
+        }
+    }
 
+    return positional;
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -586,14 +537,22 @@ void run_astar_misplaced_tiles_experiments() {
 
 int main( int argc, char* argv[] ){
    
-   string path;
   
+    argc = extractSearchOptions(argc, argv);
 
 	if(argc < 3){
         cout << "<< SEARCH ALGORITHMS >>" << endl;
 		cout << "please include missing parameters." << endl;
         cout << "SYNTAX #1: search.exe <TYPE_OF_RUN = \"batch_run\" or \"single_run\" or \"animate_run\"> ALGORITHM_NAME \"INITIAL STATE\" \"GOAL STATE\" " << endl;
         cout << "SYNTAX #2: search.exe <TYPE_OF_RUN = \"batch_run\"> ALGORITHM_NAME" << endl;
+        cout << "STATES:    \"123456780\" (3x3), \"1,2,...,15,0\" (any square board) or \"3x4:1,2,...,11,0\"; 3x3, 3x4, 4x4 and 5x5 are supported" << endl;
+        cout << "OPTIONS:   --duplicate-check=hash (default) or --duplicate-check=scan" << endl;
+        cout << "           --closed-list=hash (default) or --closed-list=bitset" << endl;
+        cout << "           --frontier=heap (default) or --frontier=buckets (open list of uc_explist and astar_explist_*)" << endl;
+        cout << "           --parent-pruning=on (default) or --parent-pruning=off" << endl;
+        cout << "           --threads=N (parallel searches, default: all cores)" << endl;
+        cout << "           --batch-workers=N (searches run at once by batch_run, default: all cores)" << endl;
+        cout << "           --pdb-file=PATH (pattern database file, default: puzzle8.pdb, built if missing)" << endl;
 		exit(0);
 	}
     
@@ -614,28 +573,7 @@ int main( int argc, char* argv[] ){
     std::transform(algorithmSelected.begin(), algorithmSelected.end(), algorithmSelected.begin(), ::tolower);
     
 
-	int pathLength=0;
-	// int depth=0;
-    int numOfStateExpansions=0;	
-	int maxQLength=0;
-    int numOfDeletionsFromMiddleOfHeap=0;
-    int numOfLocalLoopsAvoided=0;
-    int numOfAttemptedNodeReExpansions=0;
-
-	float actualRunningTime=0.0;	
-	
-#if defined __unix__ || defined __APPLE__
-    // init graphics
-    int GraphDriver=DETECT,GraphMode;
-    initgraph( &GraphDriver, &GraphMode, const_cast<char*>("") ); // Start Window
-
-#elif defined __WIN32__    
-    // init graphics
-    int graphDriver = 0;
-    int graphMode = 0;
-    initgraph(&graphDriver, &graphMode, "", WIDTH, HEIGHT);   
-#endif
-
+    SearchResult result;
 	
 try{
     if( (typeOfRun == "single_run") || (typeOfRun == "animate_run") ){
@@ -661,48 +599,92 @@ try{
         else if (algorithmSelected == "astar_explist_manhattan") {
             cout << setw(31) << std::left << "3) astar_explist_manhattan";
         }
+        else if (algorithmSelected == "idastar_misplacedtiles") {
+            cout << setw(31) << std::left << "4) idastar_misplacedtiles";
+        }
+        else if (algorithmSelected == "uc_bidirectional") {
+            cout << setw(31) << std::left << "6) uc_bidirectional";
+        }
+        else if (algorithmSelected == "distance_oracle") {
+            cout << setw(31) << std::left << "7) distance_oracle";
+        }
+        else if (algorithmSelected == "idastar_manhattan") {
+            cout << setw(31) << std::left << "5) idastar_manhattan";
+        }
+        else if (algorithmSelected == "hdastar_misplacedtiles") {
+            cout << setw(31) << std::left << "8) hdastar_misplacedtiles";
+        }
+        else if (algorithmSelected == "hdastar_manhattan") {
+            cout << setw(31) << std::left << "9) hdastar_manhattan";
+        }
+        else if (algorithmSelected == "astar_explist_pdb") {
+            cout << setw(31) << std::left << "10) astar_explist_pdb";
+        }
+        else if (algorithmSelected == "astar_explist_linearconflict") {
+            cout << setw(31) << std::left << "11) astar_explist_linearconflict";
+        }
         //---
 
+        BatchJob job;
+        job.algorithm = algorithmSelected;
+        job.initialState = initialState;
+        job.goalState = goalState;
+        runBatchJob(job, result);
+
+    } else if(typeOfRun == "batch_run") {
+
         if (algorithmSelected == "uc_explist") {
 
-            path = uc_explist(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions);
+            run_experiments("uc_explist", "uniform_cost_search");
 
-        }
-       
-        else if (algorithmSelected == "astar_explist_misplacedtiles") {
+        }else if (algorithmSelected == "astar_explist_misplacedtiles") {
 
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap, numOfLocalLoopsAvoided, numOfAttemptedNodeReExpansions, misplacedTiles);
+            run_experiments("astar_explist_misplacedtiles", "astar_misplacedtiles");
 
-        }
-        else if (algorithmSelected == "astar_explist_manhattan") {
+        }else if (algorithmSelected == "astar_explist_manhattan") {
 
-            
-            path = aStar_ExpandedList(initialState, goalState, pathLength, numOfStateExpansions, maxQLength, actualRunningTime, numOfDeletionsFromMiddleOfHeap,numOfLocalLoopsAvoided ,numOfAttemptedNodeReExpansions, manhattanDistance);
+            run_experiments("astar_explist_manhattan", "astar_manhattan");
 
-        }
+        }else if (algorithmSelected == "astar_explist_linearconflict") {
 
-    } else if(typeOfRun == "batch_run") {
+            run_experiments("astar_explist_linearconflict", "astar_linearconflict");
 
-        if (algorithmSelected == "uc_explist") {
+        }else if (algorithmSelected == "astar_explist_pdb") {
 
-            run_uc_experiments();
+            run_experiments("astar_explist_pdb", "astar_pdb");
 
-        }else if (algorithmSelected == "astar_explist_misplacedtiles") {
+        }else if (algorithmSelected == "uc_bidirectional") {
 
-            run_astar_misplaced_tiles_experiments();
+            run_experiments("uc_bidirectional", "uc_bidirectional");
 
-        }else if (algorithmSelected == "astar_explist_manhattan") {
+        }else if (algorithmSelected == "distance_oracle") {
+
+            run_experiments("distance_oracle", "distance_oracle");
+
+        }else if (algorithmSelected == "idastar_misplacedtiles") {
 
-            run_astar_manhattan_experiments();
+            run_experiments("idastar_misplacedtiles", "idastar_misplacedtiles");
+
+        }else if (algorithmSelected == "idastar_manhattan") {
+
+            run_experiments("idastar_manhattan", "idastar_manhattan");
+
+        }else if (algorithmSelected == "hdastar_misplacedtiles") {
+
+            run_experiments("hdastar_misplacedtiles", "hdastar_misplacedtiles");
+
+        }else if (algorithmSelected == "hdastar_manhattan") {
+
+            run_experiments("hdastar_manhattan", "hdastar_manhattan");
 
         }else if (algorithmSelected == "all") {
-            using std::chrono::system_clock;
-            system_clock::time_point start;             
-            start = std::chrono::system_clock::now();
+            using std::chrono::steady_clock;
+            steady_clock::time_point start;             
+            start = std::chrono::steady_clock::now();
 
             run_all_experiments();
 
-            auto end = std::chrono::system_clock::now();
+            auto end = std::chrono::steady_clock::now();
             std::chrono::duration<double> elapsed_seconds = end-start;
             string timeStr = to_string(elapsed_seconds.count()); 
             timeStr = timeStr + " sec.";
@@ -716,7 +698,8 @@ try{
 }
 
 catch(exception &e){
-    cout << "Standard exception: " << e.what() << endl;
+    cout << endl << "Standard exception: " << e.what() << endl;
+    return 1; //no result to report
 }
      
 
@@ -725,17 +708,23 @@ catch(exception &e){
 
     }
     else if ((typeOfRun == "single_run") || (typeOfRun == "animate_run") ){
-        if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
+        if (result.pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
 
         cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << endl << endl << "Initial State:" << std::fixed << ' ' << setw(12) << initialState << endl;
         cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Goal State:" << std::fixed << ' ' << setw(12) << goalState << endl;
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << endl << "Path Length:" << std::fixed << ' ' << setw(12) << pathLength << endl;
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Num Of State Expansions:" << std::fixed << ' ' << setw(12) << numOfStateExpansions << endl;
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Max Q Length:" << std::fixed << ' ' << setw(12) << maxQLength << endl;
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Actual Running Time:" << std::fixed << ' ' << setprecision(6) << setw(12) << actualRunningTime << endl;
-
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Num of Deletions from MiddleOfHeap:" << std::fixed << ' ' << setprecision(6) << setw(12) << numOfDeletionsFromMiddleOfHeap << endl;
-        cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Num of Attempted Node ReExpansions:" << std::fixed << ' ' << setprecision(6) << setw(12) << numOfAttemptedNodeReExpansions << endl;
+        cout << endl;
+        for (int c = 0; c < NUM_OF_RESULT_COLUMNS; c++) {
+            if (resultColumns[c].label == NULL) continue;
+            cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << resultColumns[c].label << std::fixed << ' ' << setw(12);
+            resultColumns[c].print(cout, result);
+            cout << endl;
+        }
+        for (size_t t = 0; t < result.numOfExpansionsPerThread.size(); t++) {
+            cout << setprecision(6) << setw(25) << std::setfill(' ') << std::right << "Expansions by Thread " << t << ":" << std::fixed << ' ' << setw(12) << result.numOfExpansionsPerThread[t] << endl;
+        }
+#ifdef PROFILE_PHASES
+        printPhaseProfile(result.phases);
+#endif
 
 
         cout << "================================================================================================================" << endl << endl;
@@ -743,15 +732,25 @@ catch(exception &e){
     }  
     
     if(typeOfRun == "animate_run"){
-        if (pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
-
-        if (path != "") {            
-            AnimateSolution(initialState, goalState, path);            
+        if (result.pathLength == 0) cout << "\n\n*---- NO SOLUTION found. (Q is empty!) ----*" << endl;
+
+#ifndef HEADLESS
+        if (result.path != "") {
+            vector<int> tiles;
+            BoardShape shape = parseBoard(initialState, tiles);
+            if (shape.rows == 3 && shape.cols == 3) {
+                openGraphicsWindow();
+                AnimateSolution(initialState, goalState, result.path);
+                closegraph();
+            } else {
+                cout << "animate_run draws 3x3 boards only." << endl;
+            }
         }
+#else
+        cout << "animate_run is not available in this build (compiled with HEADLESS)." << endl;
+#endif
 	}
     
-    closegraph();
-    
     // Show that we have exited without an error. 
     return 0;
 }
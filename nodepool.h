@@ -0,0 +1,86 @@
+#ifndef __NODEPOOL_H__
+#define __NODEPOOL_H__
+
+#include <new>
+#include <vector>
+#include <type_traits>
+
+#include "puzzle.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Per-search arena for search nodes (any BasicPuzzle size).
+//
+// Nodes are carved out of large chunks, released nodes go onto a free
+// list and are handed out again first. Nothing is returned to the heap
+// until the pool itself is destroyed, at which point every chunk is freed
+// in one go (nodes are trivially destructible, so no destructors run).
+//
+/////////////////////////////////////////////////////
+
+template <class Node>
+class NodePool{
+
+private:
+
+    static_assert(is_trivially_destructible<Node>::value, "NodePool frees nodes without running destructors");
+
+    union Slot{
+        Slot *next;
+        alignas(Node) unsigned char node[sizeof(Node)];
+    };
+
+    static const int CHUNK_SIZE = 4096; //nodes per chunk
+
+    vector<Slot*> chunks;
+    Slot *freeList;
+    int usedInChunk;
+    long numOfAllocations;
+
+    void *allocate(){
+        numOfAllocations++;
+        if(freeList != NULL){
+            Slot *slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+        if(chunks.empty() || usedInChunk == CHUNK_SIZE){
+            chunks.push_back(new Slot[CHUNK_SIZE]);
+            usedInChunk = 0;
+        }
+        return &chunks.back()[usedInChunk++];
+    }
+
+public:
+
+    NodePool() : freeList(NULL), usedInChunk(0), numOfAllocations(0) {}
+
+    ~NodePool(){
+        for(Slot *chunk : chunks){
+            delete [] chunk;
+        }
+    }
+
+    Node *create(const Node &p){
+        return new (allocate()) Node(p);
+    }
+
+    void release(Node *p){
+        Slot *slot = reinterpret_cast<Slot*>(p);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    long getNumOfAllocations() const { return numOfAllocations; }
+    long getNumOfChunks() const { return (long)chunks.size(); }
+    long getNumOfBytes() const { return (long)(chunks.size() * CHUNK_SIZE * sizeof(Slot)); } //nothing is freed before the pool, so this is also the peak
+
+private:
+
+    NodePool(const NodePool &);
+    NodePool &operator=(const NodePool &);
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "oracle.h"
+#include "permutation.h"
+
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+//bound to a const& by vector::assign, so it needs a definition of its own
+const unsigned char DistanceOracle::UNREACHABLE;
+
+//for a blank at cell n, the cell the blank moves to for 'U', 'R', 'D' and 'L' (-1 if off the board)
+static const char moveNames[4] = {'U', 'R', 'D', 'L'};
+static const int blankTarget[BOARD_CELLS][4] = {
+	{-1, 1, 3, -1}, {-1, 2, 4, 0}, {-1, -1, 5, 1},
+	{ 0, 4, 6, -1}, { 1, 5, 7, 3}, { 2, -1, 8, 4},
+	{ 3, 7, -1, -1}, { 4, 8, -1, 6}, { 5, -1, -1, 7}
+};
+
+static int blankCell(PuzzleState state){
+	for(int n=0; n < BOARD_CELLS; n++){
+		if(getTile(state, n) == 0) return n;
+	}
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////
+//backward breadth-first search over the goal's parity class
+//////////////////////////////////////////////////////////////
+DistanceOracle::DistanceOracle(string const goal){
+	PuzzleState goalState = stateFromString(goal);
+	
+	goalParity = tileParity(goalState);
+	distances.assign(NUM_REACHABLE_STATES, UNREACHABLE);
+	
+	//every state of the class is queued exactly once, so the queue is a flat array
+	vector<PuzzleState> queue;
+	queue.reserve(NUM_REACHABLE_STATES);
+	queue.push_back(goalState);
+	distances[rankState(goalState)] = 0;
+	
+	for(size_t head = 0; head < queue.size(); head++){
+		PuzzleState state = queue[head];
+		int blank = blankCell(state);
+		unsigned char next = distances[rankState(state)] + 1;
+		
+		for(int m=0; m < 4; m++){
+			int target = blankTarget[blank][m];
+			if(target < 0) continue;
+			
+			PuzzleState neighbour = slideTile(state, target, blank);
+			int rank = rankState(neighbour);
+			if(distances[rank] == UNREACHABLE){
+				distances[rank] = next;
+				queue.push_back(neighbour);
+			}
+		}
+	}
+}
+
+int DistanceOracle::distanceOf(PuzzleState state) const{
+	if(tileParity(state) != goalParity) return -1;
+	return distances[rankState(state)];
+}
+
+string DistanceOracle::solve(PuzzleState state) const{
+	string path;
+	int distance = distanceOf(state);
+	
+	if(distance <= 0) return path;
+	path.reserve(distance);
+	
+	//some neighbour is always exactly one move closer
+	while(distance > 0){
+		int blank = blankCell(state);
+		for(int m=0; m < 4; m++){
+			int target = blankTarget[blank][m];
+			if(target < 0) continue;
+			
+			PuzzleState neighbour = slideTile(state, target, blank);
+			if(distances[rankState(neighbour)] == distance - 1){
+				path.push_back(moveNames[m]);
+				state = neighbour;
+				distance--;
+				break;
+			}
+		}
+	}
+	return path;
+}
+
+//tables are keyed by canonical goal, so at most one per blank cell is ever built
+const DistanceOracle *DistanceOracle::forGoal(string const goal){
+	static map<PuzzleState, DistanceOracle> oracles;
+	static mutex oraclesLock;
+	
+	PuzzleState canonical = canonicalGoal(stateFromString(goal));
+	
+	lock_guard<mutex> guard(oraclesLock);
+	map<PuzzleState, DistanceOracle>::iterator it = oracles.find(canonical);
+	if(it == oracles.end()){
+		it = oracles.insert(make_pair(canonical, DistanceOracle(stateToString(canonical)))).first;
+	}
+	return &it->second;
+}
@@ -0,0 +1,46 @@
+#ifndef __ORACLE_H__
+#define __ORACLE_H__
+
+#include <string>
+#include <vector>
+
+#include "puzzle.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Exact distance-to-goal for every state of the 8-puzzle.
+//
+// One backward breadth-first search from the goal fills a byte per state,
+// indexed by rankState(). Any start of the goal's parity class is then
+// solved by greedy descent: from each state, step to a neighbour that is
+// one move closer, so no search is needed at all.
+//
+/////////////////////////////////////////////////////
+
+class DistanceOracle{
+
+private:
+
+    int goalParity;
+    vector<unsigned char> distances; //by rank, UNREACHABLE for the other parity class
+
+public:
+
+    static const unsigned char UNREACHABLE = 0xFF;
+
+    explicit DistanceOracle(string const goal);
+
+    //optimal number of moves to the goal, -1 if the goal cannot be reached from state
+    int distanceOf(PuzzleState state) const;
+
+    //optimal move sequence from state to the goal, "" if unreachable or already there
+    string solve(PuzzleState state) const;
+
+    //returns the table for canonicalGoal(goal), running the backward search on first use;
+    //states passed to it must first go through relabelForGoal(state, goal)
+    static const DistanceOracle *forGoal(string const goal);
+};
+
+#endif
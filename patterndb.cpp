@@ -0,0 +1,234 @@
+#include "patterndb.h"
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+#if defined __WIN32__
+	//no mmap: the file is read into memory instead
+	#include <process.h>
+	#define getpid _getpid
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+string PatternDatabase::fileName = "puzzle8.pdb";
+
+static const unsigned char groupTiles[PDB_NUM_GROUPS][PDB_GROUP_SIZE] = {{1, 2, 3, 4}, {5, 6, 7, 8}};
+
+//cells next to each cell, -1 terminated
+static const int neighbours[BOARD_CELLS][5] = {
+	{1, 3, -1}, {0, 2, 4, -1}, {1, 5, -1},
+	{0, 4, 6, -1}, {1, 3, 5, 7, -1}, {2, 4, 8, -1},
+	{3, 7, -1}, {4, 6, 8, -1}, {5, 7, -1}
+};
+
+static const size_t PDB_DATA_SIZE = (size_t)BOARD_CELLS * PDB_NUM_GROUPS * PDB_TABLE_SIZE;
+
+//cells of the blank and the group's tiles -> 0 .. PDB_TABLE_SIZE-1 (mixed radix 9,8,7,6,5)
+static int patternRank(const int cells[PDB_GROUP_SIZE + 1]){
+	unsigned int used = 0;
+	int rank = 0;
+
+	for(int k=0; k <= PDB_GROUP_SIZE; k++){
+		int digit = cells[k] - __builtin_popcount(used & ((1u << cells[k]) - 1));
+		rank = rank * (BOARD_CELLS - k) + digit;
+		used |= 1u << cells[k];
+	}
+	return rank;
+}
+
+//cell of tile 'label' in the canonical goal with its blank at goalBlank
+static int canonicalCell(int label, int goalBlank){
+	return (label - 1 < goalBlank) ? label - 1 : label;
+}
+
+//////////////////////////////////////////////////////////////
+//lookup
+//////////////////////////////////////////////////////////////
+int PatternDatabase::h(PuzzleState canonicalState, int goalBlank) const{
+	int cellOf[BOARD_CELLS];
+
+	for(int n=0; n < BOARD_CELLS; n++){
+		cellOf[getTile(canonicalState, n)] = n;
+	}
+
+	int sum = 0;
+	for(int g=0; g < PDB_NUM_GROUPS; g++){
+		int cells[PDB_GROUP_SIZE + 1];
+		cells[0] = cellOf[0];
+		for(int k=0; k < PDB_GROUP_SIZE; k++){
+			cells[k + 1] = cellOf[groupTiles[g][k]];
+		}
+		sum += tables[(goalBlank * PDB_NUM_GROUPS + g) * PDB_TABLE_SIZE + patternRank(cells)];
+	}
+	return sum;
+}
+
+//////////////////////////////////////////////////////////////
+//0-1 BFS backwards from each goal: moving a group tile costs 1, any other tile 0
+//////////////////////////////////////////////////////////////
+struct PatternNode{
+	int cells[PDB_GROUP_SIZE + 1]; //blank first, then the group's tiles
+	int distance;
+};
+
+void PatternDatabase::build(){
+	buffer.assign(PDB_DATA_SIZE, 0xFF);
+
+	for(int goalBlank=0; goalBlank < BOARD_CELLS; goalBlank++){
+		for(int g=0; g < PDB_NUM_GROUPS; g++){
+			unsigned char *table = &buffer[(goalBlank * PDB_NUM_GROUPS + g) * PDB_TABLE_SIZE];
+			deque<PatternNode> queue;
+
+			PatternNode start;
+			start.cells[0] = goalBlank;
+			for(int k=0; k < PDB_GROUP_SIZE; k++){
+				start.cells[k + 1] = canonicalCell(groupTiles[g][k], goalBlank);
+			}
+			start.distance = 0;
+			table[patternRank(start.cells)] = 0;
+			queue.push_back(start);
+
+			while(!queue.empty()){
+				PatternNode node = queue.front();
+				queue.pop_front();
+				if(node.distance > table[patternRank(node.cells)]) continue; //reached more cheaply since queued
+
+				int blank = node.cells[0];
+				for(int i=0; neighbours[blank][i] >= 0; i++){
+					int target = neighbours[blank][i];
+					PatternNode next = node;
+					int cost = 0;
+
+					next.cells[0] = target;
+					for(int k=1; k <= PDB_GROUP_SIZE; k++){
+						if(node.cells[k] == target){
+							next.cells[k] = blank;
+							cost = 1;
+						}
+					}
+					next.distance = node.distance + cost;
+
+					unsigned char &known = table[patternRank(next.cells)];
+					if(next.distance < known){
+						known = (unsigned char)next.distance;
+						if(cost == 0) queue.push_front(next);
+						else queue.push_back(next);
+					}
+				}
+			}
+		}
+	}
+	tables = &buffer[0];
+}
+
+//////////////////////////////////////////////////////////////
+//file
+//////////////////////////////////////////////////////////////
+static void fillHeader(PatternDatabaseFileHeader &header){
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "PDB8", 4);
+	header.version = PDB_FILE_VERSION;
+	header.numOfGoalBlankCells = BOARD_CELLS;
+	header.numOfGroups = PDB_NUM_GROUPS;
+	header.tableSize = PDB_TABLE_SIZE;
+	memcpy(header.groups, groupTiles, sizeof(header.groups));
+}
+
+static bool headerMatches(const void *data){
+	PatternDatabaseFileHeader expected;
+	fillHeader(expected);
+	return memcmp(data, &expected, sizeof(expected)) == 0;
+}
+
+bool PatternDatabase::load(string const file){
+	const size_t fileSize = sizeof(PatternDatabaseFileHeader) + PDB_DATA_SIZE;
+
+#if defined __WIN32__
+	FILE *in = fopen(file.c_str(), "rb");
+	if(in == NULL) return false;
+
+	vector<unsigned char> contents(fileSize + 1);
+	size_t n = fread(&contents[0], 1, contents.size(), in);
+	fclose(in);
+	if(n != fileSize || !headerMatches(&contents[0])) return false;
+
+	buffer.assign(contents.begin() + sizeof(PatternDatabaseFileHeader), contents.begin() + fileSize);
+	tables = &buffer[0];
+	return true;
+#else
+	int fd = open(file.c_str(), O_RDONLY);
+	if(fd < 0) return false;
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || (size_t)info.st_size != fileSize){
+		close(fd);
+		return false;
+	}
+	void *data = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) return false;
+
+	if(!headerMatches(data)){
+		munmap(data, fileSize);
+		return false;
+	}
+	mapping = data;
+	mappingSize = fileSize;
+	tables = (const unsigned char *)data + sizeof(PatternDatabaseFileHeader);
+	return true;
+#endif
+}
+
+//written under a temporary name first, so a concurrent reader never maps a half-written file;
+//the name carries the process id, so two processes building the database never write the same file
+bool PatternDatabase::save(string const file) const{
+	string temporary = file + "." + to_string((long long)getpid()) + ".tmp";
+	FILE *out = fopen(temporary.c_str(), "wb");
+	if(out == NULL) return false;
+
+	PatternDatabaseFileHeader header;
+	fillHeader(header);
+	bool ok = fwrite(&header, sizeof(header), 1, out) == 1 && fwrite(tables, 1, PDB_DATA_SIZE, out) == PDB_DATA_SIZE;
+	ok = (fclose(out) == 0) && ok;
+
+#if defined __WIN32__
+	remove(file.c_str()); //rename does not replace an existing file on Windows
+#endif
+	if(!ok || rename(temporary.c_str(), file.c_str()) != 0){
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////
+//construction
+//////////////////////////////////////////////////////////////
+PatternDatabase::PatternDatabase(string const file) : tables(NULL), mapping(NULL), mappingSize(0){
+	if(!load(file)){
+		build();
+		save(file); //the tables are usable from memory even if the file cannot be written
+	}
+}
+
+PatternDatabase::~PatternDatabase(){
+#if !defined __WIN32__
+	if(mapping != NULL) munmap(mapping, mappingSize);
+#endif
+}
+
+void PatternDatabase::setFileName(string const file){
+	fileName = file;
+}
+
+const PatternDatabase *PatternDatabase::instance(){
+	static PatternDatabase database(fileName); //initialised once, even with several searches starting together
+	return &database;
+}
@@ -0,0 +1,76 @@
+#ifndef __PATTERNDB_H__
+#define __PATTERNDB_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "puzzle.h"
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Additive disjoint pattern database for the 8-puzzle.
+//
+// Tiles are split into two groups, {1,2,3,4} and {5,6,7,8} (named as in
+// the canonical goal, see relabelForGoal()). For each group, a 0-1 BFS
+// backwards from the goal records how many moves of that group's tiles
+// are needed from every placement of the blank and the group's 4 tiles;
+// moves of the other tiles are free. Only the group's own moves are
+// counted, so the two lookups add up to an admissible, consistent h.
+//
+// One table pair is kept per goal blank cell, which covers every goal.
+// All 18 tables are saved in a versioned binary file. On later runs the
+// file is memory-mapped (read into memory on Windows) and used as is.
+//
+/////////////////////////////////////////////////////
+
+const int PDB_NUM_GROUPS = 2;
+const int PDB_GROUP_SIZE = 4;
+const int PDB_TABLE_SIZE = 15120; // 9*8*7*6*5 placements of the blank and 4 tiles
+
+const uint32_t PDB_FILE_VERSION = 1;
+
+struct PatternDatabaseFileHeader{
+    char magic[4];                  //"PDB8"
+    uint32_t version;               //PDB_FILE_VERSION
+    uint32_t numOfGoalBlankCells;   //BOARD_CELLS
+    uint32_t numOfGroups;           //PDB_NUM_GROUPS
+    uint32_t tableSize;             //PDB_TABLE_SIZE
+    unsigned char groups[PDB_NUM_GROUPS][PDB_GROUP_SIZE];
+};
+
+class PatternDatabase{
+
+private:
+
+    const unsigned char *tables;    //[goal blank cell][group][pattern rank]
+    vector<unsigned char> buffer;   //owns the tables when they are built or read, not mapped
+    void *mapping;
+    size_t mappingSize;
+
+    static string fileName;
+
+    explicit PatternDatabase(string const file);
+    PatternDatabase(const PatternDatabase&); //not copyable
+
+    bool load(string const file);
+    void build();
+    bool save(string const file) const;
+
+public:
+
+    ~PatternDatabase();
+
+    //h for a state, with the tiles already renamed by relabelForGoal() towards a goal with its blank at goalBlank
+    int h(PuzzleState canonicalState, int goalBlank) const;
+
+    //the database file used on first access; built and written there if missing or stale
+    static void setFileName(string const file);
+
+    //loads (or builds) the database on first use
+    static const PatternDatabase *instance();
+};
+
+#endif
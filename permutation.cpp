@@ -0,0 +1,88 @@
+#include "permutation.h"
+
+using namespace std;
+
+// (7-i)!/2 for the first six Lehmer digits of the tile permutation
+static const int halfFactorial[6] = {2520, 360, 60, 12, 3, 1};
+
+//////////////////////////////////////////////////////////////
+//state -> rank in 0 .. 9!/2 - 1
+//////////////////////////////////////////////////////////////
+int rankState(PuzzleState state){
+	int blank = 0;
+	int i = 0;
+	int rank = 0;
+	unsigned int unused = 0x1FE; //tiles 1..8 not placed yet
+	
+	for(int n=0; n < BOARD_CELLS; n++){
+		int tile = getTile(state, n);
+		if(tile == 0){
+			blank = n;
+			continue;
+		}
+		if(i < 6){
+			//Lehmer digit: how many smaller tiles are still to come
+			rank += __builtin_popcount(unused & ((1u << tile) - 1)) * halfFactorial[i];
+		}
+		unused &= ~(1u << tile);
+		i++;
+	}
+	
+	return blank * NUM_TILE_PERMUTATIONS + rank;
+}
+
+//////////////////////////////////////////////////////////////
+//rank -> state, for the permutation class with the given parity
+//////////////////////////////////////////////////////////////
+PuzzleState unrankState(int rank, int parity){
+	int blank = rank / NUM_TILE_PERMUTATIONS;
+	int rest = rank % NUM_TILE_PERMUTATIONS;
+	int digits[8];
+	int digitSum = 0;
+	
+	for(int i=0; i < 6; i++){
+		digits[i] = rest / halfFactorial[i];
+		rest %= halfFactorial[i];
+		digitSum += digits[i];
+	}
+	//the inversion count has the same parity as the sum of the Lehmer digits
+	digits[6] = (parity + digitSum) & 1;
+	digits[7] = 0;
+	
+	PuzzleState state = 0;
+	unsigned int unused = 0x1FE;
+	int i = 0;
+	
+	for(int n=0; n < BOARD_CELLS; n++){
+		if(n == blank) continue;
+		
+		//pick the digits[i]-th smallest tile not used yet
+		int tile = 1;
+		for(int skip = digits[i]; ; tile++){
+			if(unused & (1u << tile)){
+				if(skip == 0) break;
+				skip--;
+			}
+		}
+		unused &= ~(1u << tile);
+		state |= (PuzzleState)tile << (4 * n);
+		i++;
+	}
+	
+	return state;
+}
+
+int tileParity(PuzzleState state){
+	int inversions = 0;
+	unsigned int seen = 0;
+	
+	for(int n=0; n < BOARD_CELLS; n++){
+		int tile = getTile(state, n);
+		if(tile == 0) continue;
+		//placed tiles larger than this one form an inversion with it
+		inversions += __builtin_popcount(seen & ~((1u << (tile + 1)) - 1));
+		seen |= 1u << tile;
+	}
+	
+	return inversions & 1;
+}
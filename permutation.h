@@ -0,0 +1,30 @@
+#ifndef __PERMUTATION_H__
+#define __PERMUTATION_H__
+
+#include "puzzle.h"
+
+/////////////////////////////////////////////////////
+//
+// Perfect hashing of 8-puzzle states.
+//
+// Only half of the 9! boards are reachable from any given start (the
+// parity of the tile permutation, blank ignored, never changes), so a
+// state is ranked as
+//
+//      rank = blankCell * 8!/2 + lehmerRank(tiles) / 2
+//
+// which maps every state of one parity class onto 0 .. 9!/2 - 1 without
+// gaps. The dropped Lehmer digit is recovered from the parity on unrank.
+//
+/////////////////////////////////////////////////////
+
+const int NUM_TILE_PERMUTATIONS = 20160;   // 8!/2
+const int NUM_REACHABLE_STATES  = 181440;  // 9!/2
+
+int rankState(PuzzleState state);
+PuzzleState unrankState(int rank, int parity);
+
+//parity (0 or 1) of the tile permutation, the blank is ignored
+int tileParity(PuzzleState state);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef __PHASEPROFILE_H__
+#define __PHASEPROFILE_H__
+
+#include <chrono>
+
+#if defined __x86_64__ || defined __i386__
+    #include <x86intrin.h>
+#endif
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Per-phase breakdown of a search's hot path: how often each phase ran
+// and how many cycles it took, added up over the whole search.
+//
+// Only compiled in with -DPROFILE_PHASES (make PROFILE_PHASES=1). In any
+// other build PROFILE_PHASE() expands to nothing and every count stays 0,
+// so the search loops pay nothing for it.
+//
+// Cycles are read from the time-stamp counter (x86) or the virtual counter
+// (ARM64); elsewhere steady_clock nanoseconds stand in for them. Each timed
+// phase also pays for two counter reads, so very short phases look slower
+// than they are. Compare phases with each other, not with the search time.
+//
+/////////////////////////////////////////////////////
+
+enum searchPhase{
+    successorGeneration,    //copying a node into a successor
+    heuristicEvaluation,    //h and f of a successor
+    closedListLookup,       //expanded-list tests and inserts
+    duplicateCheck,         //looking a successor up among the queued nodes, and keeping that index up to date
+    queuePush,
+    queuePop,
+    queueReplace,           //decrease-key: a queued node swapped for a cheaper one
+    NUM_OF_SEARCH_PHASES
+};
+
+inline const char *phaseName(int phase){
+    static const char *names[NUM_OF_SEARCH_PHASES] = {
+        "Successor Generation", "Heuristic Evaluation", "Closed List Lookup", "Duplicate Check",
+        "Queue Push", "Queue Pop", "Queue Replace"
+    };
+    return names[phase];
+}
+
+struct PhaseProfile{
+    long long calls[NUM_OF_SEARCH_PHASES];
+    long long cycles[NUM_OF_SEARCH_PHASES];
+
+    PhaseProfile(){
+        for(int p=0; p < NUM_OF_SEARCH_PHASES; p++){
+            calls[p] = 0;
+            cycles[p] = 0;
+        }
+    }
+
+    void add(const PhaseProfile &other){
+        for(int p=0; p < NUM_OF_SEARCH_PHASES; p++){
+            calls[p] += other.calls[p];
+            cycles[p] += other.cycles[p];
+        }
+    }
+};
+
+inline unsigned long long cycleCount(){
+#if defined __x86_64__ || defined __i386__
+    return __rdtsc();
+#elif defined __aarch64__
+    unsigned long long ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//charges the time until the end of the enclosing scope to one phase
+class PhaseTimer{
+
+private:
+
+    PhaseProfile &profile;
+    searchPhase phase;
+    unsigned long long start;
+
+public:
+
+    PhaseTimer(PhaseProfile &profile, searchPhase phase) : profile(profile), phase(phase), start(cycleCount()) {}
+
+    ~PhaseTimer(){
+        profile.cycles[phase] += (long long)(cycleCount() - start);
+        profile.calls[phase]++;
+    }
+};
+
+#define PHASE_TIMER_NAME(line) phaseTimer##line
+#define PHASE_TIMER(line) PHASE_TIMER_NAME(line)
+
+#ifdef PROFILE_PHASES
+    #define PROFILE_PHASE(profile, phase) PhaseTimer PHASE_TIMER(__LINE__)((profile), (phase))
+#else
+    #define PROFILE_PHASE(profile, phase) ((void)0)
+#endif
+
+#endif
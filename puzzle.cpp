@@ -1,29 +1,267 @@
 #include "puzzle.h"
+#include "nodepool.h"
+#include "patterndb.h"
 #include  <cmath>
 #include  <assert.h>
+#include  <cctype>
+#include  <cstdlib>
+#include  <map>
+#include  <mutex>
+#include  <stdexcept>
 
 using namespace std;
 
 //////////////////////////////////////////////////////////////
-//constructor
+//string <-> packed state conversion, only used at the API edge
 //////////////////////////////////////////////////////////////
-Puzzle::Puzzle(const Puzzle &p) : path(p.path){
+BoardShape parseBoard(string const text, vector<int> &tiles){
+	BoardShape shape = {0, 0};
+	bool shapeGiven = false;
+	string list = text;
+	
+	tiles.clear();
+	size_t colon = text.find(':');
+	if(colon != string::npos){
+		string size = text.substr(0, colon);
+		char *end = NULL;
+		shape.rows = (int)strtol(size.c_str(), &end, 10);
+		if(*end != 'x' || !isdigit((unsigned char)end[1])) throw invalid_argument("board \"" + text + "\": expected RxC: in front of the tiles");
+		shape.cols = (int)strtol(end + 1, &end, 10);
+		if(*end != '\0') throw invalid_argument("board \"" + text + "\": expected RxC: in front of the tiles");
+		if(shape.rows < 2 || shape.cols < 2) throw invalid_argument("board \"" + text + "\": a board needs at least 2 rows and 2 columns");
+		shapeGiven = true;
+		list = text.substr(colon + 1);
+	}
+	
+	if(list.find(',') == string::npos){
+		//one digit per tile
+		for(size_t i=0; i < list.size(); i++){
+			if(!isdigit((unsigned char)list[i])) throw invalid_argument("board \"" + text + "\": tiles must be numbers");
+			tiles.push_back(list[i] - '0');
+		}
+	}else{
+		size_t start = 0;
+		while(true){
+			size_t comma = list.find(',', start);
+			string tile = list.substr(start, (comma == string::npos) ? string::npos : comma - start);
+			if(tile.empty() || tile.size() > 3 || tile.find_first_not_of("0123456789") != string::npos){
+				throw invalid_argument("board \"" + text + "\": tiles must be numbers");
+			}
+			tiles.push_back(atoi(tile.c_str()));
+			if(comma == string::npos) break;
+			start = comma + 1;
+		}
+	}
+	
+	int numOfTiles = (int)tiles.size();
+	if(!shapeGiven){
+		int side = (int)lround(sqrt((double)numOfTiles));
+		if(side * side != numOfTiles) throw invalid_argument("board \"" + text + "\": not a square board, give its shape as RxC:");
+		shape.rows = shape.cols = side;
+	}
+	if(shape.rows * shape.cols != numOfTiles) throw invalid_argument("board \"" + text + "\": wrong number of tiles for its shape");
+	
+	vector<bool> seen(numOfTiles, false);
+	for(int n=0; n < numOfTiles; n++){
+		if(tiles[n] >= numOfTiles || seen[tiles[n]]) throw invalid_argument("board \"" + text + "\": tiles must be 0 .. " + to_string(numOfTiles - 1) + ", each once");
+		seen[tiles[n]] = true;
+	}
+	return shape;
+}
+
+template<int ROWS, int COLS>
+typename BoardLayout<ROWS, COLS>::State BoardLayout<ROWS, COLS>::fromString(string const text){
+	vector<int> tiles;
+	BoardShape shape = parseBoard(text, tiles);
+	
+	if(shape.rows != ROWS || shape.cols != COLS){
+		throw invalid_argument("board \"" + text + "\": expected a " + to_string(ROWS) + "x" + to_string(COLS) + " board");
+	}
+	State state = 0;
+	for(int n=0; n < CELLS; n++){
+		state |= (State)tiles[n] << (TILE_BITS * n);
+	}
+	return state;
+}
+
+template<int ROWS, int COLS>
+string BoardLayout<ROWS, COLS>::toString(State state){
+	if(ROWS == 3 && COLS == 3){
+		string s(CELLS, '0');
+		for(int n=0; n < CELLS; n++){
+			s[n] = (char)('0' + getTile(state, n));
+		}
+		return s;
+	}
+	
+	string s = (ROWS == COLS) ? "" : to_string(ROWS) + "x" + to_string(COLS) + ":";
+	for(int n=0; n < CELLS; n++){
+		if(n > 0) s += ',';
+		s += to_string(getTile(state, n));
+	}
+	return s;
+}
+
+template<int ROWS, int COLS>
+int BoardLayout<ROWS, COLS>::parityClass(State state){
+	int inversions = 0;
+	int blankRow = 0;
+	
+	for(int n=0; n < CELLS; n++){
+		int tile = getTile(state, n);
+		if(tile == 0){
+			blankRow = n / COLS;
+			continue;
+		}
+		for(int m=n+1; m < CELLS; m++){
+			int later = getTile(state, m);
+			if(later != 0 && later < tile) inversions++;
+		}
+	}
+	//on an even width a vertical move passes over an odd number of tiles, flipping the inversion parity
+	return (COLS % 2 == 0) ? (inversions + blankRow) & 1 : inversions & 1;
+}
+
+PuzzleState stateFromString(string const elements){
+	return BoardLayout<3, 3>::fromString(elements);
+}
+
+string stateToString(PuzzleState state){
+	return BoardLayout<3, 3>::toString(state);
+}
+
+PuzzleState relabelForGoal(PuzzleState state, PuzzleState goal){
+	int label[BOARD_CELLS] = {0};
+	int next = 1;
+	
+	for(int n=0; n < BOARD_CELLS; n++){
+		int tile = getTile(goal, n);
+		if(tile != 0) label[tile] = next++;
+	}
+	
+	PuzzleState relabeled = 0;
+	for(int n=0; n < BOARD_CELLS; n++){
+		relabeled |= (PuzzleState)label[getTile(state, n)] << (4 * n);
+	}
+	return relabeled;
+}
+
+PuzzleState canonicalGoal(PuzzleState goal){
+	return relabelForGoal(goal, goal);
+}
+
+//////////////////////////////////////////////////////////////
+//goal context
+//////////////////////////////////////////////////////////////
+
+//the longest strictly increasing subsequence of at most 5 values has to stay in the line;
+//every other tile of the line has to step out of it and back in, 2 extra moves each
+int linePenalty(const int goalOrder[], int n){
+	int best[5];
+	int longest = 0;
+	
+	for(int i=0; i < n; i++){
+		best[i] = 1;
+		for(int j=0; j < i; j++){
+			if(goalOrder[j] < goalOrder[i] && best[j] + 1 > best[i]) best[i] = best[j] + 1;
+		}
+		if(best[i] > longest) longest = best[i];
+	}
+	return 2 * (n - longest);
+}
+
+const vector<unsigned char> &linePenaltyTable(int length){
+	static vector<unsigned char> tables[6];
+	static once_flag built[6];
+	
+	call_once(built[length], [length](){
+		int size = 1;
+		for(int i=0; i < length; i++) size *= length + 1;
+		tables[length].assign(size, 0);
+		for(int code=0; code < size; code++){
+			//digits back into goal positions, first cell first
+			int digits[5];
+			int rest = code;
+			for(int i=length - 1; i >= 0; i--){
+				digits[i] = rest % (length + 1);
+				rest /= length + 1;
+			}
+			int order[5];
+			int n = 0;
+			for(int i=0; i < length; i++){
+				if(digits[i] != 0) order[n++] = digits[i] - 1;
+			}
+			tables[length][code] = (unsigned char)linePenalty(order, n);
+		}
+	});
+	return tables[length];
+}
+
+template<int ROWS, int COLS>
+BasicGoalContext<ROWS, COLS>::BasicGoalContext(string const goal){
+	state = Layout::fromString(goal);
+	int next = 1;
+	for(int n=0; n < CELLS; n++){
+		int tile = getTile(state, n);
+		goalRow[tile] = n / COLS;
+		goalCol[tile] = n % COLS;
+		label[tile] = (tile == 0) ? 0 : (unsigned char)next++;
+	}
+	blankCell = goalRow[0] * COLS + goalCol[0];
+	for(int tile=0; tile < CELLS; tile++){
+		for(int n=0; n < CELLS; n++){
+			distance[tile][n] = (tile == 0) ? 0 : (unsigned char)(abs(n / COLS - goalRow[tile]) + abs(n % COLS - goalCol[tile]));
+		}
+	}
 	
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		    board[i][j] = p.board[i][j];
-		    goalBoard[i][j] = p.goalBoard[i][j];
+	for(int tile=0; tile < CELLS; tile++){
+		for(int row=0; row < ROWS; row++){
+			rowCode[row][tile] = (tile != 0 && goalRow[tile] == row) ? (unsigned char)(goalCol[tile] + 1) : 0;
 		}
-	}	
+		for(int col=0; col < COLS; col++){
+			colCode[col][tile] = (tile != 0 && goalCol[tile] == col) ? (unsigned char)(goalRow[tile] + 1) : 0;
+		}
+	}
+}
+
+template<int ROWS, int COLS>
+const BasicGoalContext<ROWS, COLS> *BasicGoalContext<ROWS, COLS>::forGoal(string const goal){
+	//map elements never move and contexts live until exit, so nodes can hold plain pointers to them;
+	//keyed by the parsed goal, so every way of writing the same board shares one context
+	static map<State, BasicGoalContext> contexts;
+	static mutex contextsLock;
+	
+	State key = Layout::fromString(goal);
+	
+	{
+		lock_guard<mutex> guard(contextsLock);
+		typename map<State, BasicGoalContext>::iterator it = contexts.find(key);
+		if(it != contexts.end()) return &it->second;
+	}
+	
+	//built without the lock, so searches towards other goals do not wait for it; if another
+	//thread inserted the same goal meanwhile, insert() keeps that one
+	BasicGoalContext context(goal);
+	lock_guard<mutex> guard(contextsLock);
+	return &contexts.insert(make_pair(key, context)).first->second;
+}
+
+//////////////////////////////////////////////////////////////
+//constructor
+//////////////////////////////////////////////////////////////
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS>::BasicPuzzle(const BasicPuzzle &p) : parent(p.parent), lastMove(p.lastMove){
+	
+	board = p.board;
+	goal = p.goal;
 	
 	x0 = p.x0;
 	y0 = p.y0;
-	//path = p.path;
 	pathLength = p.pathLength;
 	hCost = p.hCost;
 	fCost = p.fCost;	
-	strBoard = toString(); //uses the board contents to generate the string equivalent
 	depth = p.depth; //useful for depth-limited search only
+	heapIndex = -1; //a copy is not queued yet
 	
 }
 
@@ -31,114 +269,112 @@ Puzzle::Puzzle(const Puzzle &p) : path(p.path){
 //constructor
 //inputs:  initial state, goal state
 //////////////////////////////////////////////////////////////
-Puzzle::Puzzle(string const elements, string const goal){
-	
-	int n;
-	
-	n = 0;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		    board[i][j] = elements[n] - '0';
-		    if(board[i][j] == 0){
-			    x0 = j;
-			    y0 = i;
-			 }
-		    n++;
-		} 
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS>::BasicPuzzle(string const elements, string const goal){
+	
+	board = Layout::fromString(elements);
+	for(int n=0; n < Layout::CELLS; n++){
+		if(getTile(board, n) == 0){
+			x0 = n % COLS;
+			y0 = n / COLS;
+		}
 	}
 		
 	///////////////////////
-	n = 0;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		    goalBoard[i][j] = goal[n] - '0';
-		    n++;
-		} 
-	}		
+	this->goal = BasicGoalContext<ROWS, COLS>::forGoal(goal);
 	///////////////////////	
-	path = "";
+	parent = NULL;
+	lastMove = 0;
 	pathLength=0;
 	hCost = 0;
 	fCost = 0;
 	depth = 0;
-	strBoard = toString();	
+	heapIndex = -1;
 }
 
 
-void Puzzle::setDepth(int d){
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::setDepth(int d){
 	depth = d;
 }
 
-int Puzzle::getDepth(){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::getDepth(){
 	return depth;
 }
 
-void Puzzle::updateHCost(heuristicFunction hFunction){
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::updateHCost(heuristicFunction hFunction){
 	hCost = h(hFunction);
 }
 
-void Puzzle::updateFCost(){
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::updateHCost(heuristicFunction hFunction, const BasicPuzzle &parent){
+	switch(hFunction){
+		case misplacedTiles:    updateHCost<misplacedTiles>(parent); break;
+		case manhattanDistance: updateHCost<manhattanDistance>(parent); break;
+		case patternDatabase:   updateHCost<patternDatabase>(parent); break;
+		case linearConflict:    updateHCost<linearConflict>(parent); break;
+	}
+}
+
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::updateFCost(){
     fCost = pathLength + hCost; // f = g + h
 }
 
-int Puzzle::getFCost(){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::getFCost(){
 	return fCost;
 }
 
-int Puzzle::getHCost(){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::getHCost(){
 	return hCost;
 }
 
-int Puzzle::getGCost(){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::getGCost(){
 	return pathLength;
 }
 
 //Heuristic function implementation
-int Puzzle::h(heuristicFunction heuristic){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::h(heuristicFunction heuristic){
     int sum = 0;
     int h = 0;
     int numOfMisplacedTiles = 0;
     
     switch(heuristic){
         case misplacedTiles:
-            // we count misplaced tiles minus the blank tile
-            for(int i = 0; i < 3; i++){
-                for(int j = 0; j < 3; j++){
-                    if(board[i][j] != 0 && board[i][j] != goalBoard[i][j]){
-                        numOfMisplacedTiles++;
-                    }
-                }
+            // we count misplaced tiles minus the blank tile (its distance is always 0)
+            for(int n = 0; n < Layout::CELLS; n++){
+                numOfMisplacedTiles += (goal->distance[getTile(board, n)][n] != 0);
             }
             h = numOfMisplacedTiles;
             break;
          
         case manhattanDistance:
-            // Calculate sum of Manhattan distances for each misplaced tile
-            for(int i = 0; i < 3; i++){
-                for(int j = 0; j < 3; j++){
-                    if(board[i][j] != 0){ // Skip blank tile
-                        int value = board[i][j]; 
-                        // we find where this tile should belong and setting the row and column number
-                        int goalRow = -1, goalCol = -1;
-                        for(int gi = 0; gi < 3; gi++){
-                            for(int gj = 0; gj < 3; gj++){
-                                if(goalBoard[gi][gj] == value){
-                                    goalRow = gi;
-                                    goalCol = gj;
-                                    break;
-                                }
-                            }
-                            if(goalRow != -1) break;
-                        }
-                        // we calculate the Manhattan distance
-                        if(goalRow != -1 && goalCol != -1){
-                            sum += abs(i - goalRow) + abs(j - goalCol);
-                        }
-                    }
-                }
+            // Sum of Manhattan distances, looked up per tile and cell from the goal context
+            for(int n = 0; n < Layout::CELLS; n++){
+                sum += goal->distance[getTile(board, n)][n];
             }
             h = sum;
             break;         
+         
+        case linearConflict:
+            // Manhattan plus the row and column conflict penalties, one table lookup per line
+            for(int n = 0; n < Layout::CELLS; n++){
+                sum += goal->distance[getTile(board, n)][n];
+            }
+            h = sum + goal->conflicts(board);
+            break;
+         
+        case patternDatabase:
+            // Additive disjoint pattern database, looked up with the tiles renamed towards the canonical goal;
+            // 3x3 boards only, the searches turn it down for any other size
+            h = PatternDatabase::instance()->h((PuzzleState)goal->canonical(board), goal->blankCell);
+            break;
     }
     
     return h;
@@ -146,191 +382,230 @@ int Puzzle::h(heuristicFunction heuristic){
 
 
 //converts board state into its string representation
-string Puzzle::toString(){
-  int n;
-  string stringPath;
-  
-  n=0;
-  for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){			    
-		    stringPath.insert(stringPath.end(), board[i][j] + '0');
-		    n++;
-		} 
-  }
-  
-//  cout << "toString = " << stringPath << endl;
-  
-  return stringPath;
-}
-
-
-
-bool Puzzle::goalMatch(){
-    for(int i = 0; i < 3; i++){
-        for(int j = 0; j < 3; j++){
-            if(board[i][j] != goalBoard[i][j]){
-                return false;
-            }
-        }
-    }
-    return true;
+template<int ROWS, int COLS>
+string BasicPuzzle<ROWS, COLS>::toString(){
+  return Layout::toString(board);
+}
+
+
+
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::goalMatch(){
+    return board == goal->state;
 }
 
-bool Puzzle::canMoveLeft(){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveLeft(){
    return (x0 > 0);
 	
 }
 
-const string Puzzle::getPath(){
+template<int ROWS, int COLS>
+const string BasicPuzzle<ROWS, COLS>::getPath(){
+	string path(pathLength, ' ');
+	const BasicPuzzle *node = this;
+	
+	for(int i = pathLength - 1; i >= 0; i--){
+		path[i] = node->lastMove;
+		node = node->parent;
+	}
 	return path;
 }
 
-bool Puzzle::canMoveRight(){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveRight(){
 
-   return (x0 < 2);
+   return (x0 < COLS - 1);
 	
 }
 
 
-bool Puzzle::canMoveUp(){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveUp(){
 
    return (y0 > 0);
 	
 }
 
-bool Puzzle::canMoveDown(){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveDown(){
 
-   return (y0 < 2);
+   return (y0 < ROWS - 1);
 	
 }
 
 ///////////////////////////////////////////////
 //these functions will be useful for Progressive Deepening Search 
 
-bool Puzzle::canMoveLeft(int maxDepth){
-  	
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveLeft(int maxDepth){
+   
+   //the move must be legal and the successor must not go deeper than maxDepth
+   return canMoveLeft() && (depth < maxDepth);
 }
-bool Puzzle::canMoveRight(int maxDepth){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveRight(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   //the move must be legal and the successor must not go deeper than maxDepth
+   return canMoveRight() && (depth < maxDepth);
 }
 
 
-bool Puzzle::canMoveUp(int maxDepth){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveUp(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   //the move must be legal and the successor must not go deeper than maxDepth
+   return canMoveUp() && (depth < maxDepth);
 }
 
-bool Puzzle::canMoveDown(int maxDepth){
+template<int ROWS, int COLS>
+bool BasicPuzzle<ROWS, COLS>::canMoveDown(int maxDepth){
    
-  	bool m=false;
-  	//put your implementations here
-  	return m; 
+   //the move must be legal and the successor must not go deeper than maxDepth
+   return canMoveDown() && (depth < maxDepth);
+}
+
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::applyMove(char move, heuristicFunction hFunction){
+	
+	int to = y0*COLS + x0;
+	
+	switch(move){
+		case 'U': y0--; break;
+		case 'D': y0++; break;
+		case 'L': x0--; break;
+		case 'R': x0++; break;
+	}
+	
+	int from = y0*COLS + x0;
+	if(hFunction == patternDatabase){
+		board = slideTile(board, from, to);
+		hCost = h(hFunction);
+	}else{
+		State before = board;
+		hCost += goal->hDelta(hFunction, getTile(board, from), from, to);
+		board = slideTile(board, from, to);
+		if(hFunction == linearConflict){
+			hCost += goal->conflictDelta(before, board, from, to);
+		}
+	}
+	
+	pathLength++;
+	depth++;
+	fCost = pathLength + hCost;
+	
+#ifdef DEBUG_INCREMENTAL_H
+	assert(hCost == h(hFunction));
+#endif
+}
+
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::undoMove(char move, heuristicFunction hFunction){
+	
+	//sliding the tile back is itself a move, so g and depth drop by two steps' worth
+	applyMove(inverseMove(move), hFunction);
+	
+	pathLength -= 2;
+	depth -= 2;
+	fCost = pathLength + hCost;
 }
 
 ///////////////////////////////////////////////
 
-Puzzle *Puzzle::moveLeft(){
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS> *BasicPuzzle<ROWS, COLS>::moveLeft(NodePool<BasicPuzzle> *pool){
 	
-	Puzzle *p = new Puzzle(*this);
+	BasicPuzzle *p = (pool != NULL) ? pool->create(*this) : new BasicPuzzle(*this);
 	
 	
    if(x0 > 0){
 		
-		p->board[y0][x0] = p->board[y0][x0-1];
-		p->board[y0][x0-1] = 0;
+		p->board = slideTile(board, y0*COLS + x0-1, y0*COLS + x0);
 		
 		p->x0--;
 		
-		p->path = path + "L";
+		p->parent = this;
+		p->lastMove = 'L';
 		p->pathLength = pathLength + 1;  
 		p->depth = depth + 1; 
 		
 		
 	}
-	p->strBoard = p->toString();
 
 	return p;
 	
 }
 
 
-Puzzle *Puzzle::moveRight(){
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS> *BasicPuzzle<ROWS, COLS>::moveRight(NodePool<BasicPuzzle> *pool){
 	
-   Puzzle *p = new Puzzle(*this);
+   BasicPuzzle *p = (pool != NULL) ? pool->create(*this) : new BasicPuzzle(*this);
 	
 	
-   if(x0 < 2){
+   if(x0 < COLS - 1){
 		
-		p->board[y0][x0] = p->board[y0][x0+1];
-		p->board[y0][x0+1] = 0;
+		p->board = slideTile(board, y0*COLS + x0+1, y0*COLS + x0);
 		
 		p->x0++;
 		
-		p->path = path + "R";
+		p->parent = this;
+		p->lastMove = 'R';
 		p->pathLength = pathLength + 1; 
      	
 		p->depth = depth + 1;
 		
 	}
 	
-	p->strBoard = p->toString();
 	
 	return p;
 	
 }
 
 
-Puzzle *Puzzle::moveUp(){
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS> *BasicPuzzle<ROWS, COLS>::moveUp(NodePool<BasicPuzzle> *pool){
 	
-   Puzzle *p = new Puzzle(*this);
+   BasicPuzzle *p = (pool != NULL) ? pool->create(*this) : new BasicPuzzle(*this);
 	
 	
    if(y0 > 0){
 		
-		p->board[y0][x0] = p->board[y0-1][x0];
-		p->board[y0-1][x0] = 0;
+		p->board = slideTile(board, (y0-1)*COLS + x0, y0*COLS + x0);
 		
 		p->y0--;
 		
-		p->path = path + "U";
+		p->parent = this;
+		p->lastMove = 'U';
 		p->pathLength = pathLength + 1;  
 	
 		p->depth = depth + 1;
 		
 	}
-	p->strBoard = p->toString();
 	
 	return p;
 	
 }
 
-Puzzle *Puzzle::moveDown(){
+template<int ROWS, int COLS>
+BasicPuzzle<ROWS, COLS> *BasicPuzzle<ROWS, COLS>::moveDown(NodePool<BasicPuzzle> *pool){
 	
-   Puzzle *p = new Puzzle(*this);
+   BasicPuzzle *p = (pool != NULL) ? pool->create(*this) : new BasicPuzzle(*this);
 	
 	
-   if(y0 < 2){
+   if(y0 < ROWS - 1){
 		
-		p->board[y0][x0] = p->board[y0+1][x0];
-		p->board[y0+1][x0] = 0;
+		p->board = slideTile(board, (y0+1)*COLS + x0, y0*COLS + x0);
 		
 		p->y0++;
 		
-		p->path = path + "D";
+		p->parent = this;
+		p->lastMove = 'D';
 		p->pathLength = pathLength + 1;  
 		
 		p->depth = depth + 1;
 		
 	}
-	p->strBoard = p->toString();	
 	
 	return p;
 	
@@ -339,17 +614,36 @@ Puzzle *Puzzle::moveDown(){
 /////////////////////////////////////////////////////
 
 
-void Puzzle::printBoard(){
+template<int ROWS, int COLS>
+void BasicPuzzle<ROWS, COLS>::printBoard(){
 	cout << "board: "<< endl;
-	for(int i=0; i < 3; i++){
-		for(int j=0; j < 3; j++){	
-		  cout << endl << "board[" << i << "][" << j << "] = " << board[i][j];
+	for(int i=0; i < ROWS; i++){
+		for(int j=0; j < COLS; j++){	
+		  cout << endl << "board[" << i << "][" << j << "] = " << getTile(board, i*COLS + j);
 		}
 	}
 	cout << endl;
 	
 }
 
-int Puzzle::getPathLength(){
+template<int ROWS, int COLS>
+int BasicPuzzle<ROWS, COLS>::getPathLength(){
 	return pathLength;
 }
+
+/////////////////////////////////////////////////////
+//the board sizes the searches are compiled for
+template struct BoardLayout<3, 3>;
+template struct BoardLayout<3, 4>;
+template struct BoardLayout<4, 4>;
+template struct BoardLayout<5, 5>;
+
+template struct BasicGoalContext<3, 3>;
+template struct BasicGoalContext<3, 4>;
+template struct BasicGoalContext<4, 4>;
+template struct BasicGoalContext<5, 5>;
+
+template class BasicPuzzle<3, 3>;
+template class BasicPuzzle<3, 4>;
+template class BasicPuzzle<4, 4>;
+template class BasicPuzzle<5, 5>;
@@ -1,80 +1,329 @@
+#ifndef __PUZZLE_H__
+#define __PUZZLE_H__
+
 #include <string>
+#include <vector>
 #include <iostream>
+#include <functional>
+#include <type_traits>
+#include <stdint.h>
+#include <assert.h>
 
 using namespace std;
 
 
-enum heuristicFunction{misplacedTiles, manhattanDistance};
+enum heuristicFunction{misplacedTiles, manhattanDistance, patternDatabase, linearConflict};
+
+
+//////////////////////////////////////////////////////////////
+//packed board: cell (row, col) = row*COLS + col. Boards of up to 16 cells
+//(3x3, 3x4, 4x4) keep 4 bits per cell in one word, cell n in bits [4n, 4n+4);
+//larger ones (5x5) take 5 bits per cell in a 128-bit WidePuzzleState.
+//getTile() and slideTile() pick the encoding from the state type.
+//////////////////////////////////////////////////////////////
+typedef uint64_t PuzzleState;
+typedef unsigned __int128 WidePuzzleState;
+
+const int BOARD_CELLS = 9; //the 3x3 board, the only one covered by the rank, oracle and pattern database tables
+
+inline int getTile(PuzzleState state, int cell){
+    return (int)((state >> (4 * cell)) & 0xF);
+}
+
+inline int getTile(WidePuzzleState state, int cell){
+    return (int)((state >> (5 * cell)) & 0x1F);
+}
+
+//moves the tile at cell 'from' into the blank at cell 'to'
+inline PuzzleState slideTile(PuzzleState state, int from, int to){
+    PuzzleState tile = (state >> (4 * from)) & 0xF;
+    return state ^ (tile << (4 * from)) ^ (tile << (4 * to));
+}
+
+inline WidePuzzleState slideTile(WidePuzzleState state, int from, int to){
+    WidePuzzleState tile = (state >> (5 * from)) & 0x1F;
+    return state ^ (tile << (5 * from)) ^ (tile << (5 * to));
+}
+
+//hash of either state type, for unordered containers
+struct PuzzleStateHash{
+    size_t operator()(PuzzleState state) const {
+        return hash<uint64_t>()(state);
+    }
+    size_t operator()(WidePuzzleState state) const {
+        return hash<uint64_t>()((uint64_t)state ^ ((uint64_t)(state >> 64) * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+//the move that undoes 'move' ('U' <-> 'D', 'L' <-> 'R')
+inline char inverseMove(char move){
+    switch(move){
+        case 'U': return 'D';
+        case 'D': return 'U';
+        case 'L': return 'R';
+        case 'R': return 'L';
+    }
+    return 0;
+}
+
+template<class Node> class NodePool;
+
+
+//////////////////////////////////////////////////////////////
+//board strings: "123456780" (one digit per tile, square boards), or the
+//tiles separated by commas, "1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0", for
+//a square board of any size; an "RxC:" prefix gives the shape of any
+//other board, e.g. "3x4:1,2,3,4,5,6,7,8,9,10,11,0"
+//////////////////////////////////////////////////////////////
+struct BoardShape{
+    int rows;
+    int cols;
+};
+
+//shape and tiles (in cell order) of a board string; throws invalid_argument
+//unless the tiles are 0 .. rows*cols-1, each exactly once
+BoardShape parseBoard(string const text, vector<int> &tiles);
+
+//one board size, fixed at compile time
+template<int ROWS, int COLS>
+struct BoardLayout{
+    static const int CELLS = ROWS * COLS;
+    static const int TILE_BITS = (CELLS <= 16) ? 4 : 5;
+    typedef typename conditional<(CELLS <= 16), PuzzleState, WidePuzzleState>::type State;
+
+    static_assert(ROWS >= 2 && COLS >= 2 && CELLS <= 25, "boards from 2x2 up to 5x5 fit the state encodings");
+
+    static State fromString(string const text); //throws invalid_argument for a board of another shape
+    static string toString(State state);        //digits for 3x3, the comma form otherwise
+
+    //0 or 1, never changed by a move, so states of different classes are not connected:
+    //the parity of the tile inversions, plus the blank's row on boards of even width
+    static int parityClass(State state);
+};
+
+//3x3 states at the API edge, e.g. for the rank, oracle and pattern database tables
+PuzzleState stateFromString(string const elements);
+string stateToString(PuzzleState state);
+
+//goal relabeling: renaming tiles so that 'goal' reads 1..8 in cell order (blank left in place)
+//maps every goal onto one of 9 canonical goals. Moves only name the blank's direction, so a
+//move sequence solving relabelForGoal(initial, goal) -> canonicalGoal(goal) also solves initial -> goal.
+PuzzleState relabelForGoal(PuzzleState state, PuzzleState goal);
+PuzzleState canonicalGoal(PuzzleState goal);
+
+//linear-conflict penalty of one row or column, from the goal positions (along the line) of the
+//tiles that belong to it, in line order: 2 moves for every tile outside the longest increasing run
+int linePenalty(const int goalOrder[], int n);
+
+//linePenalty() of every line of 'length' cells (3..5), indexed by the line's code: one base length+1
+//digit per cell, first cell most significant; 0 for the blank or a tile of another line, otherwise
+//1 + the tile's goal position along the line. It does not depend on the goal, so one table per
+//length is built, on first use, and only by the linear-conflict heuristic.
+const vector<unsigned char> &linePenaltyTable(int length);
+
+
+//////////////////////////////////////////////////////////////
+//everything derived from the goal state, built once per goal and
+//shared (read-only) by every node of every search towards that goal
+//////////////////////////////////////////////////////////////
+template<int ROWS, int COLS>
+struct BasicGoalContext{
+    typedef BoardLayout<ROWS, COLS> Layout;
+    typedef typename Layout::State State;
+    static const int CELLS = Layout::CELLS;
+
+    State state;
+    int goalRow[CELLS]; //tile -> row it belongs to in the goal (index 0 is the blank)
+    int goalCol[CELLS]; //tile -> column it belongs to in the goal
+    unsigned char distance[CELLS][CELLS]; //[tile][cell] -> Manhattan distance to the tile's goal cell, 0 for the blank
+    unsigned char label[CELLS]; //tile -> its name towards the canonical goal, as in relabelForGoal()
+    int blankCell;              //goal cell of the blank
+
+    //[line][tile] -> the tile's digit in the code of that row/column, see linePenaltyTable()
+    unsigned char rowCode[ROWS][CELLS];
+    unsigned char colCode[COLS][CELLS];
+
+    explicit BasicGoalContext(string const goal);
+
+    int rowPenalty(State state, int row) const {
+        static const vector<unsigned char> &table = linePenaltyTable(COLS);
+        int code = 0;
+        for(int col=0; col < COLS; col++){
+            code = code * (COLS + 1) + rowCode[row][getTile(state, row * COLS + col)];
+        }
+        return table[code];
+    }
+
+    int columnPenalty(State state, int col) const {
+        static const vector<unsigned char> &table = linePenaltyTable(ROWS);
+        int code = 0;
+        for(int row=0; row < ROWS; row++){
+            code = code * (ROWS + 1) + colCode[col][getTile(state, row * COLS + col)];
+        }
+        return table[code];
+    }
+
+    //sum of the penalties of all rows and columns, added on top of Manhattan by linearConflict
+    int conflicts(State state) const {
+        int sum = 0;
+        for(int row=0; row < ROWS; row++) sum += rowPenalty(state, row);
+        for(int col=0; col < COLS; col++) sum += columnPenalty(state, col);
+        return sum;
+    }
+
+    //change of conflicts() when a tile slides from cell 'from' into the blank at cell 'to': only the
+    //two lines it moves between can change (the order within the line it moves along stays the same)
+    int conflictDelta(State before, State after, int from, int to) const {
+        if(from / COLS == to / COLS){
+            int a = from % COLS, b = to % COLS;
+            return columnPenalty(after, a) + columnPenalty(after, b) - columnPenalty(before, a) - columnPenalty(before, b);
+        }
+        int a = from / COLS, b = to / COLS;
+        return rowPenalty(after, a) + rowPenalty(after, b) - rowPenalty(before, a) - rowPenalty(before, b);
+    }
 
+    //relabelForGoal(state, goal) from the precomputed labels
+    State canonical(State state) const {
+        State relabeled = 0;
+        for(int n=0; n < CELLS; n++){
+            relabeled |= (State)label[getTile(state, n)] << (Layout::TILE_BITS * n);
+        }
+        return relabeled;
+    }
+
+    //change of the heuristic when 'tile' slides from cell 'from' into the blank at cell 'to';
+    //the Manhattan part only for linearConflict (see conflictDelta), and not defined for
+    //patternDatabase, whose lookups all change when the blank moves
+    int hDelta(heuristicFunction hFunction, int tile, int from, int to) const {
+        if(hFunction == misplacedTiles){
+            return (distance[tile][to] != 0) - (distance[tile][from] != 0);
+        }
+        return distance[tile][to] - distance[tile][from];
+    }
+
+    //returns the context for this goal, creating it on first use
+    static const BasicGoalContext *forGoal(string const goal);
+};
+
+
+template<int ROWS, int COLS>
+class BasicPuzzle{
+
+public:
+
+    typedef BoardLayout<ROWS, COLS> Layout;
+    typedef typename Layout::State State;
 
-class Puzzle{
-        
 private:
 
-    string path;
+    const BasicPuzzle *parent; //node this one was generated from, NULL for the start state
+    char lastMove;        //'U', 'R', 'D' or 'L': the move that produced this node from its parent
     int pathLength;
     int hCost;
     int fCost;
     int depth; //useful for depth-limited search only
-        
-    int goalBoard[3][3];
-    
+    int heapIndex; //slot in the search queue, maintained by IndexedHeap (-1 when not queued)
+
+    const BasicGoalContext<ROWS, COLS> *goal; //shared, never owned by a node
+
     int x0, y0; //coordinates of the blank or 0-tile
-    
-    int board[3][3];
-    
+
+    State board;
+
 public:
-    
-    string strBoard;
-     
 
-    Puzzle(const Puzzle &p); //Constructor
-    Puzzle(string const elements, string const goal);
-     
+
+    BasicPuzzle(const BasicPuzzle &p); //Constructor
+    BasicPuzzle(string const elements, string const goal);
+
     void printBoard();
-    
-    int h(heuristicFunction hFunction);   
-    void updateFCost(); 
+
+    int h(heuristicFunction hFunction);
+    void updateFCost();
     void updateHCost(heuristicFunction hFunction);
+    void updateHCost(heuristicFunction hFunction, const BasicPuzzle &parent); //O(1) update for a node one move away from parent
+    template<heuristicFunction H> void updateHCost(const BasicPuzzle &parent); //the same with h fixed at compile time, inlined into the caller
     void updateDepth(){
          depth++;
-    }        
-          
-     
+    }
+
+
     bool goalMatch();
      string toString();
-    
+
     string getString(){
-        return strBoard;
+        return toString();
      }
-    
+
+    State getState() const { return board; }
+    char getLastMove() const { return lastMove; }
+    const BasicPuzzle *getParent() const { return parent; }
+
     bool canMoveLeft();
     bool canMoveRight();
     bool canMoveUp();
-    bool canMoveDown();  
+    bool canMoveDown();
 
 //----------------------------------------
-//these functions will be useful for Progressive Deepening Search only    
+//these functions will be useful for Progressive Deepening Search only
      bool canMoveLeft(int maxDepth);
      bool canMoveDown(int maxDepth);
      bool canMoveRight(int maxDepth);
-     bool canMoveUp(int maxDepth);   
+     bool canMoveUp(int maxDepth);
+
+//in-place moves for depth-first searches: g, depth and h (incrementally, for hFunction)
+//follow the board, parent and lastMove are left alone
+     void applyMove(char move, heuristicFunction hFunction);
+     void undoMove(char move, heuristicFunction hFunction);
 //----------------------------------------
-      
-    Puzzle * moveUp();
-    Puzzle * moveRight();
-    Puzzle * moveDown();
-    Puzzle * moveLeft();
-     
-     
-    const string getPath();
-    
+
+    //successors come from the search's NodePool when one is given, otherwise from new
+    BasicPuzzle * moveUp(NodePool<BasicPuzzle> *pool = NULL);
+    BasicPuzzle * moveRight(NodePool<BasicPuzzle> *pool = NULL);
+    BasicPuzzle * moveDown(NodePool<BasicPuzzle> *pool = NULL);
+    BasicPuzzle * moveLeft(NodePool<BasicPuzzle> *pool = NULL);
+
+
+    const string getPath(); //rebuilt by walking the parent chain, call once the goal is reached
+
     void setDepth(int d);
     int getDepth();
-    
+
     int getPathLength();
     int getFCost();
     int getHCost();
-    int getGCost(); 
-    
+    int getGCost();
+
+    int getHeapIndex() const { return heapIndex; }
+    void setHeapIndex(int index){ heapIndex = index; }
+
 };
+
+//only the tile that moved changes its contribution, so h is carried over from the parent.
+//build with -DDEBUG_INCREMENTAL_H to cross-check every update against the full h()
+template<int ROWS, int COLS>
+template<heuristicFunction H>
+inline void BasicPuzzle<ROWS, COLS>::updateHCost(const BasicPuzzle &parent){
+    if(H == patternDatabase){
+        hCost = h(H); //the blank takes part in every pattern, so each lookup changes
+        return;
+    }
+
+    int from = y0*COLS + x0;               //the blank now sits where the tile came from
+    int to = parent.y0*COLS + parent.x0;   //and the tile sits where the blank was
+
+    hCost = parent.hCost + goal->hDelta(H, getTile(board, to), from, to);
+    if(H == linearConflict){
+        hCost += goal->conflictDelta(parent.board, board, from, to);
+    }
+
+#ifdef DEBUG_INCREMENTAL_H
+    assert(hCost == h(H));
+#endif
+}
+
+//the 8-puzzle
+typedef BasicPuzzle<3, 3> Puzzle;
+typedef BasicGoalContext<3, 3> GoalContext;
+
+#endif
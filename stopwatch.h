@@ -0,0 +1,69 @@
+#ifndef __STOPWATCH_H__
+#define __STOPWATCH_H__
+
+#include <chrono>
+
+#if defined __WIN32__
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+using namespace std;
+
+/////////////////////////////////////////////////////
+//
+// Wall and CPU time since the stopwatch was started, in nanoseconds.
+//
+// Wall time is read from steady_clock, which is monotonic, so it is the
+// latency a caller sees. CPU time is the calling thread's own
+// (CLOCK_THREAD_CPUTIME_ID, GetThreadTimes on Windows with 100 ns ticks):
+// unlike clock(), which adds up every thread of the process, it is not
+// inflated by searches running side by side in a batch. Time spent in
+// other threads, e.g. an OpenMP team, is not included.
+//
+/////////////////////////////////////////////////////
+
+inline long long threadCpuNanoseconds(){
+#if defined __WIN32__
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime);
+    ULARGE_INTEGER ticks; //100 ns units
+    ticks.LowPart = userTime.dwLowDateTime;
+    ticks.HighPart = userTime.dwHighDateTime;
+    return (long long)ticks.QuadPart * 100;
+#else
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+#endif
+}
+
+class Stopwatch{
+
+private:
+
+    chrono::steady_clock::time_point wallStart;
+    long long cpuStart;
+
+public:
+
+    Stopwatch() { restart(); }
+
+    void restart(){
+        wallStart = chrono::steady_clock::now();
+        cpuStart = threadCpuNanoseconds();
+    }
+
+    long long wallNanoseconds() const {
+        return (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - wallStart).count();
+    }
+
+    //CPU time of the calling thread, which must be the one that started the stopwatch
+    long long cpuNanoseconds() const {
+        return threadCpuNanoseconds() - cpuStart;
+    }
+};
+
+#endif